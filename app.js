@@ -80,11 +80,24 @@ console.log('Running app at localhost: ' + portNum);
 let cLibrary = ffi.Library('./sharedLib', {
   'saveGEDCOM': [ 'void' , [ 'string', 'string', 'string' ] ],
   'createIndJSON': [ 'string', [ 'string' ] ],
-  'JSONaddindi' : ['void' , [ 'string', 'string', 'string' ] ],
+  //returns the ErrorCode of appendIndividual, 0 (OK) once the individual is written
+  'JSONaddindi' : ['int' , [ 'string', 'string', 'string' ] ],
   'filterfiles': [ 'string', [ 'string' ] ],
   //'JSONdescendants': ['string', ['string', 'string', 'string', 'int']],
   //'JSONancestors': ['string', ['string', 'string', 'string', 'int']]
-  'GEDCOMtoJSON': [ 'string', [ 'string' ] ]
+  'GEDCOMtoJSON': [ 'string', [ 'string' ] ],
+  //sessions keep a file parsed between requests, named by the int openSession returns
+  'openSession': [ 'int', [ 'string' ] ],
+  'closeSession': [ 'void', [ 'int' ] ],
+  'sessionSummaryJSON': [ 'string', [ 'int' ] ],
+  'sessionIndividualsJSON': [ 'string', [ 'int' ] ],
+  'sessionDescendantsJSON': [ 'string', [ 'int', 'string', 'string', 'int' ] ],
+  'sessionAncestorsJSON': [ 'string', [ 'int', 'string', 'string', 'int' ] ],
+  'sessionAddIndividual': [ 'bool', [ 'int', 'string', 'string' ] ],
+  'sessionWrite': [ 'int', [ 'int', 'string' ] ],
+  //batches answer many relative queries at once, one per line as "ancestors|descendants\tnum\tgiven\tsurname"
+  'sessionBatchJSON': [ 'string', [ 'int', 'string', 'int' ] ],
+  'batchJSON': [ 'string', [ 'string', 'string', 'int' ] ]
 });
 
 app.get('/getFiles', function(req , res){
@@ -132,7 +145,11 @@ app.get('/addIndi', function(req , res){
   let firstname = req.query.firstname;
   let secondname = req.query.secondname;
 
-  cLibrary.JSONaddindi('uploads/' + file, firstname, secondname);
+  let error = cLibrary.JSONaddindi('uploads/' + file, firstname, secondname);
+
+  res.send({
+    error: error
+  });
 
 });
 
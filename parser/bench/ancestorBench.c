@@ -0,0 +1,145 @@
+/**
+ * @file ancestorBench.c
+ * @brief Compares "is X an ancestor of Y" answered by an AncestorIndex with the same question answered
+ * by calling getAncestorListN and looking through the copies, as a caller of the list API has to.
+ * Usage: ancestorBench file.ged [pairs]
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "GEDCOMparser.h"
+#include "GEDCOMgraph.h"
+
+/** Function to read a monotonic clock
+*@return the time in seconds
+**/
+static double now(void){
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/** Function to answer the question from a list of generations of copies
+*@return true if a copy with the ancestor's name is in one of the generations
+*@param generations - list returned by getAncestorListN
+*@param ancestor - the possible ancestor
+**/
+static bool inGenerations(List generations, const Individual* ancestor){
+    ListIterator iter = createIterator(generations);
+    while(iter.current != NULL){
+        ListIterator inner = createIterator(*(List*)iter.current->data);
+        while(inner.current != NULL){
+            if(compareIndividuals(inner.current->data, ancestor) == 0){
+                return true;
+            }
+            nextElement(&inner);
+        }
+        nextElement(&iter);
+    }
+
+    return false;
+}
+
+int main(int argc, char** argv){
+    if(argc < 2){
+        fprintf(stderr, "usage: %s file.ged [pairs]\n", argv[0]);
+        return 1;
+    }
+    int pairs = argc > 2 ? atoi(argv[2]) : 200;
+    if(pairs < 1){
+        pairs = 1;
+    }
+
+    GEDCOMobject* obj = NULL;
+    GEDCOMerror error = createGEDCOMflags(argv[1], &obj, LOAD_GRAPH);
+    if(error.type != OK){
+        char* text = printError(error);
+        fprintf(stderr, "%s\n", text);
+        free(text);
+        return 1;
+    }
+
+    double start = now();
+    AncestorIndex* index = createAncestorIndex(obj);
+    double buildTime = now() - start;
+    if(index == NULL){
+        fprintf(stderr, "cannot build the ancestor index\n");
+        deleteGEDCOM(obj);
+        return 1;
+    }
+    const FamilyGraph* graph = index->graph;
+    if(graph->individualCount == 0){
+        fprintf(stderr, "no individuals\n");
+        deleteAncestorIndex(index);
+        deleteGEDCOM(obj);
+        return 1;
+    }
+
+    //half of the pairs are real ancestors a few generations up, the rest are random
+    srand(1);
+    const Individual** ancestors = malloc(sizeof(Individual*) * pairs);
+    const Individual** people = malloc(sizeof(Individual*) * pairs);
+    bool* answers = malloc(sizeof(bool) * pairs);
+    if(ancestors == NULL || people == NULL || answers == NULL){
+        fprintf(stderr, "no memory for %d pairs\n", pairs);
+        free(ancestors);
+        free(people);
+        free(answers);
+        deleteAncestorIndex(index);
+        deleteGEDCOM(obj);
+        return 1;
+    }
+    for(int i = 0; i < pairs; i++){
+        int person = rand() % graph->individualCount;
+        int ancestor = rand() % graph->individualCount;
+        if(i % 2 == 0){
+            ancestor = person;
+            for(int steps = 1 + rand() % 8; steps > 0; steps--){
+                int parents = graph->parentStart[ancestor + 1] - graph->parentStart[ancestor];
+                if(parents == 0){
+                    break;
+                }
+                ancestor = graph->parentIds[graph->parentStart[ancestor] + rand() % parents];
+            }
+        }
+        ancestors[i] = graph->individuals[ancestor];
+        people[i] = graph->individuals[person];
+    }
+
+    int indexYes = 0;
+    int listYes = 0;
+    int disagree = 0;
+
+    start = now();
+    for(int i = 0; i < pairs; i++){
+        answers[i] = isAncestor(index, ancestors[i], people[i]);
+        indexYes += answers[i];
+    }
+    double indexTime = now() - start;
+
+    start = now();
+    for(int i = 0; i < pairs; i++){
+        List generations = getAncestorListN(obj, people[i], 0);
+        bool answer = ancestors[i] != people[i] && inGenerations(generations, ancestors[i]);
+        clearList(&generations);
+        listYes += answer;
+        disagree += answer != answers[i];
+    }
+    double listTime = now() - start;
+
+    printf("individuals      %d\n", graph->individualCount);
+    printf("pairs            %d (%d ancestors by index, %d by lists, %d disagree)\n", pairs, indexYes, listYes, disagree);
+    printf("index build      %.3f s\n", buildTime);
+    printf("isAncestor       %.6f s (%.2f us per pair)\n", indexTime, indexTime * 1e6 / pairs);
+    printf("getAncestorListN %.6f s (%.2f us per pair)\n", listTime, listTime * 1e6 / pairs);
+
+    free(answers);
+    free(ancestors);
+    free(people);
+    deleteAncestorIndex(index);
+    deleteGEDCOM(obj);
+
+    return disagree == 0 ? 0 : 1;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file writeBench.c
+ * @brief Measures how fast writeGEDCOM writes a loaded file back out, in MB/s of GEDCOM written.
+ * Usage: writeBench file.ged out.ged [runs]
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "GEDCOMparser.h"
+
+/** Function to read a monotonic clock
+*@return the time in seconds
+**/
+static double now(void){
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+int main(int argc, char** argv){
+    if(argc < 3){
+        fprintf(stderr, "usage: %s file.ged out.ged [runs]\n", argv[0]);
+        return 1;
+    }
+    int runs = argc > 3 ? atoi(argv[3]) : 5;
+    if(runs < 1){
+        runs = 1;
+    }
+
+    GEDCOMobject* obj = NULL;
+    GEDCOMerror error = createGEDCOM(argv[1], &obj);
+    if(error.type != OK){
+        char* text = printError(error);
+        fprintf(stderr, "%s\n", text);
+        free(text);
+        return 1;
+    }
+
+    //the fastest run is reported, the others only differ by what else the machine was doing
+    double best = 0;
+    double total = 0;
+    for(int i = 0; i < runs; i++){
+        double start = now();
+        error = writeGEDCOM(argv[2], obj);
+        double time = now() - start;
+        if(error.type != OK){
+            fprintf(stderr, "writeGEDCOM failed on run %d\n", i + 1);
+            deleteGEDCOM(obj);
+            return 1;
+        }
+        total += time;
+        if(i == 0 || time < best){
+            best = time;
+        }
+    }
+
+    struct stat info;
+    if(stat(argv[2], &info) != 0){
+        fprintf(stderr, "cannot stat %s\n", argv[2]);
+        deleteGEDCOM(obj);
+        return 1;
+    }
+    double megabytes = info.st_size / (1024.0 * 1024.0);
+
+    printf("individuals      %d\n", getLength(obj->individuals));
+    printf("families         %d\n", getLength(obj->families));
+    printf("written          %.2f MB\n", megabytes);
+    printf("best run         %.4f s (%.1f MB/s)\n", best, megabytes / best);
+    printf("mean of %-3d runs %.4f s (%.1f MB/s)\n", runs, total / runs, megabytes * runs / total);
+
+    deleteGEDCOM(obj);
+
+    return 0;
+}
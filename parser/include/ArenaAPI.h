@@ -0,0 +1,86 @@
+/**
+ * @file ArenaAPI.h
+ * @brief File containing the function definitions of a bump allocator
+ */
+
+#ifndef _ARENA_API_
+#define _ARENA_API_
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+//size of the first block, later blocks double in size up to ARENA_MAX_BLOCK
+#define ARENA_MIN_BLOCK (64 * 1024)
+#define ARENA_MAX_BLOCK (1024 * 1024)
+
+/**
+ * Block of an arena. Allocations are handed out from data in order, used is the
+ * number of bytes handed out so far.
+ **/
+typedef struct arenaBlock{
+    struct arenaBlock* next;
+    size_t size;
+    size_t used;
+    char data[];
+} ArenaBlock;
+
+/**
+ * Metadata head of the arena.
+ * Memory is handed out from the newest block and is never freed on its own,
+ * everything is released at once by clearArena.
+ **/
+typedef struct arena{
+    ArenaBlock* head;
+    size_t blockSize;
+    size_t allocated;
+} Arena;
+
+
+/** Function to initialize an empty arena. No memory is reserved until the first allocation.
+*@return the arena struct
+**/
+Arena initializeArena(void);
+
+
+/** Function to get memory from the arena, aligned for any type.
+*@pre Arena exists and has been initialized
+*@return pointer to size bytes of uninitialized memory, valid until the arena is cleared
+*@param arena pointer to the arena
+*@param size number of bytes needed
+**/
+void* arenaAlloc(Arena* arena, size_t size);
+
+
+/** Function to copy a string into the arena.
+*@pre Arena exists and has been initialized
+*@return nul terminated copy of the first length characters of str
+*@param arena pointer to the arena
+*@param str the characters to copy, may be NULL if length is 0
+*@param length number of characters to copy
+**/
+char* arenaString(Arena* arena, const char* str, size_t length);
+
+
+/** Moves every block of one arena into another, so memory handed out by either is released with the first.
+* Allocations keep coming from the newest block of into, the blocks of from are only kept.
+*@param into pointer to the arena that takes the blocks
+*@param from pointer to the arena that gives them up, it is left empty and can be used again
+**/
+void mergeArena(Arena* into, Arena* from);
+
+
+/** Releases every block of the arena at once. The arena can be used again afterwards.
+*@param arena pointer to the arena
+**/
+void clearArena(Arena* arena);
+
+
+/**Returns the number of bytes handed out by the arena.
+ *@param arena - the arena struct.
+ **/
+size_t getArenaSize(Arena arena);
+
+#endif
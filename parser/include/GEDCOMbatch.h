@@ -0,0 +1,85 @@
+/**
+ * @file GEDCOMbatch.h
+ * @brief File containing the function definitions for running many relative queries on one GEDCOM object at once
+ */
+
+#ifndef GEDCOMBATCH_H
+#define GEDCOMBATCH_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "GEDCOMparser.h"
+#include "GEDCOMgraph.h"
+
+/**
+ * One descendant or ancestor question, as getDescendantListNView or getAncestorListNView would answer it.
+ **/
+typedef struct relativeQuery{
+    const Individual* person;
+    traverseDirection direction;
+
+    //last generation to collect, 0 for all of them
+    unsigned int maxGen;
+} RelativeQuery;
+
+/**
+ * Answer to a RelativeQuery.
+ * generations is a list of generations like getDescendantListNView returns, whose members point at the
+ * records of the GEDCOM object and are only valid while it is.  seconds is the time the query took on
+ * the thread that ran it.
+ **/
+typedef struct relativeResult{
+    List generations;
+    double seconds;
+} RelativeResult;
+
+
+/** Function to answer many relative queries on one GEDCOM object, spread over a pool of threads.
+* The object is only read, so the threads share it without locking.  Each thread takes the next query
+* nobody has started yet, so a few long queries do not hold up the rest.
+*@pre GEDCOM object exists, is not null, is valid, and does not change until the results are cleared
+*@return true on success, false if the arguments are invalid or memory ran out.  Queries a thread could not
+*be started for are answered on the calling thread.
+*@param obj - a pointer to a GEDCOMobject struct
+*@param queries - array of count queries
+*@param count - number of queries
+*@param results - array of count results, filled in the order of the queries.  Must be freed with clearRelativeResults.
+*@param threads - number of threads to use, 0 for one per processor
+**/
+bool runRelativeQueries(const GEDCOMobject* obj, const RelativeQuery* queries, int count, RelativeResult* results, int threads);
+
+
+/** Function to free the generation lists of results filled by runRelativeQueries.  The individuals belong to the GEDCOM object and are not freed.
+*@param results - array of results
+*@param count - number of results
+**/
+void clearRelativeResults(RelativeResult* results, int count);
+
+
+/** Function to answer relative queries written as text with runRelativeQueries and give the answers as JSON.
+* queries has one query per line, made of four fields split by tabs: ancestors or descendants, the most
+* generations to collect (0 for all of them), then the given name and surname of the individual, as
+* JSONancestors and JSONdescendants take them.  Blank lines are skipped.  The answer is
+* {"seconds":s,"results":[{"seconds":s,"generations":[...]},...]} with a result for each query in the
+* order of the lines, generations as gListToJSON gives them, the time of each query, and the time of the
+* whole batch.  An individual that is not found gets no generations.
+*@pre GEDCOM object exists, is not null, is valid, and does not change until the function returns
+*@return newly allocated JSON string, {} if a line is not a query
+*@param obj - a pointer to a GEDCOMobject struct
+*@param queries - the queries, one per line
+*@param threads - number of threads to use, 0 for one per processor
+**/
+char* batchToJSON(const GEDCOMobject* obj, const char* queries, int threads);
+
+
+/** Function to answer relative queries on a GEDCOM file through the cache, like batchToJSON.
+*@return newly allocated JSON string, {} if the file could not be parsed or a line is not a query
+*@param fileName - a string containing the name of the GEDCOM file
+*@param queries - the queries, one per line
+*@param threads - number of threads to use, 0 for one per processor
+**/
+char* batchJSON(char* fileName, char* queries, int threads);
+
+#endif
@@ -0,0 +1,86 @@
+/**
+ * @file GEDCOMcache.h
+ * @brief File containing the function definitions of the cache of parsed GEDCOM files kept between calls
+ */
+
+#ifndef GEDCOMCACHE_H
+#define GEDCOMCACHE_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "GEDCOMparser.h"
+
+//memory the cache may keep for files nobody is using, unless set with setGEDCOMcacheBudget
+#define GEDCOM_CACHE_BUDGET ((size_t)256 << 20)
+
+/**
+ * A parsed file held by the cache.  Handles are only given out by acquireGEDCOM, and the object
+ * stays valid until the handle is given back with releaseGEDCOM.
+ **/
+typedef struct gedcomCacheEntry GEDCOMhandle;
+
+/**
+ * Counters of the cache, as returned by getGEDCOMcacheStats.
+ **/
+typedef struct gedcomCacheStats{
+    //acquires answered from the cache, and those that parsed the file
+    unsigned long hits;
+    unsigned long misses;
+
+    //files dropped to stay in the budget, and files dropped by invalidateGEDCOM or because they changed on disk
+    unsigned long evictions;
+    unsigned long invalidations;
+
+    int entries;
+    size_t bytes;
+    size_t budget;
+} GEDCOMcacheStats;
+
+
+/** Function to get a parsed GEDCOM file, parsing it only if it is not cached already.
+* Files are known by path, and a cached file whose modification time or size has changed is parsed again.
+* Files are parsed with LOAD_INTERN | LOAD_GRAPH, so they live in one arena whose size is what the budget counts.
+* Files that are not being used are dropped, least recently used first, when the cache is over its budget.
+* A file is parsed without holding up calls for other files.  Calls for a file that is being parsed wait for
+* that parse and share its result, so each file is parsed once however many calls ask for it.
+*@return the handle, NULL if the file could not be parsed.  Must be given back with releaseGEDCOM.
+*@param fileName - a string containing the name of the GEDCOM file
+*@param error - set to the result of parsing, OK for a cached file.  May be NULL.
+**/
+GEDCOMhandle* acquireGEDCOM(const char* fileName, GEDCOMerror* error);
+
+
+/** Function to get the object of a handle.  The object belongs to the cache and must not be changed or deleted.
+*@return the GEDCOM object
+*@param handle - a handle from acquireGEDCOM
+**/
+const GEDCOMobject* getCachedGEDCOM(const GEDCOMhandle* handle);
+
+
+/** Function to give back a handle from acquireGEDCOM.  The object must not be used afterwards.
+*@param handle - the handle, may be NULL
+**/
+void releaseGEDCOM(GEDCOMhandle* handle);
+
+
+/** Function to drop a file from the cache, so the next acquire parses it again.
+* A file that is in use is freed once its last handle is released.
+*@param fileName - name of the file, NULL to drop every file
+**/
+void invalidateGEDCOM(const char* fileName);
+
+
+/** Function to set the memory the cache may keep, dropping files that are not in use until it fits.
+*@param bytes - the budget in bytes, 0 to keep nothing once it is released
+**/
+void setGEDCOMcacheBudget(size_t bytes);
+
+
+/** Function to get the counters of the cache
+*@return the counters
+**/
+GEDCOMcacheStats getGEDCOMcacheStats(void);
+
+#endif
@@ -0,0 +1,159 @@
+/**
+ * @file GEDCOMgraph.h
+ * @brief File containing the function definitions of a compressed family graph of a GEDCOM object
+ */
+
+#ifndef GEDCOMGRAPH_H
+#define GEDCOMGRAPH_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "GEDCOMparser.h"
+#include "HashTableAPI.h"
+
+//family links a traversal of relatives follows
+typedef enum {DESCENDANT_LINKS, ANCESTOR_LINKS} traverseDirection;
+
+/**
+ * Family links of a GEDCOM object in compressed sparse row form.
+ * Individuals and families are numbered from 0 in the order of the object's lists.  The children
+ * of individual i are childIds[childStart[i]] up to childIds[childStart[i + 1]], and its parents are
+ * found the same way in parentIds.  Both are in the order a walk over the Individual and Family lists
+ * finds them, so a walk over the graph visits relatives in the same order.
+ * The graph points into the object, which must not change while the graph is in use.
+ **/
+typedef struct familyGraph{
+    int individualCount;
+    int familyCount;
+
+    //records by id
+    Individual** individuals;
+    Family** families;
+
+    //ids by record, the data of each entry is the record's slot in individuals or families
+    HashTable individualIds;
+    HashTable familyIds;
+
+    //parent to child edges, from the families an individual is the husband or wife of
+    int* childStart;
+    int* childIds;
+
+    //child to parent edges, from the other families of an individual
+    int* parentStart;
+    int* parentIds;
+} FamilyGraph;
+
+
+/**
+ * Labels of the family graph that answer ancestor questions without walking the families.
+ * A depth first walk down the child edges gives every individual its position pre when it is reached
+ * and post when everything below it is done, and low is the smallest post of it and all its descendants.
+ * Individual a is an ancestor of b when b was reached below a in the walk (pre and post of b inside those
+ * of a), and can only be one when post of b lies between low and post of a.  The few pairs left between
+ * the two are settled by a search down from a that skips every individual whose labels rule b out.
+ **/
+typedef struct ancestorIndex{
+    const FamilyGraph* graph;
+
+    //graph built for the index when the object has none, freed with the index
+    FamilyGraph* ownGraph;
+
+    int* pre;
+    int* post;
+    int* low;
+} AncestorIndex;
+
+
+/** Function to number the records of a GEDCOM object and build the edge arrays of its family links.
+*@pre GEDCOM object exists, is not null, and its family links are complete
+*@return the new graph, NULL on failure.  Must be freed with deleteFamilyGraph.
+*@param obj - a pointer to a GEDCOMobject struct
+**/
+FamilyGraph* createFamilyGraph(const GEDCOMobject* obj);
+
+
+/** Function to free a graph made by createFamilyGraph.  The object is not affected.
+*@param graph - pointer to the graph, may be NULL
+**/
+void deleteFamilyGraph(FamilyGraph* graph);
+
+
+/** Function to get the id of an individual.
+*@return the id, -1 if the individual is not a record of the graph's object
+*@param graph - pointer to the graph
+*@param individual - the record to look up
+**/
+int getIndividualId(const FamilyGraph* graph, const Individual* individual);
+
+
+/** Function to get the id of a family.
+*@return the id, -1 if the family is not a record of the graph's object
+*@param graph - pointer to the graph
+*@param family - the record to look up
+**/
+int getFamilyId(const FamilyGraph* graph, const Family* family);
+
+
+/** Function to walk the descendants or ancestors of an individual breadth first over the edge arrays.
+* Relatives are visited once each, in the nearest generation, in the same order traverseRelatives uses.
+* The visited set is a bitmap over the ids.
+*@param graph - pointer to the graph
+*@param id - id of the individual the walk starts from, never visited itself
+*@param first - ids of the first generation, in the order to visit them, NULL for the edges of id
+*@param firstCount - number of ids in first
+*@param direction - links to follow
+*@param maxGen - last generation to visit, 0 for all of them
+*@param visit - function called with each relative, its generation and state
+*@param state - passed to visit
+**/
+void traverseGraph(const FamilyGraph* graph, int id, const int* first, int firstCount, traverseDirection direction, unsigned int maxGen, void (*visit)(Individual* relative, int generation, void* state), void* state);
+
+
+/** Function to label the family graph of a GEDCOM object for ancestor questions.
+* The graph the object was loaded with is used if it has one, otherwise one is built for the index.
+*@pre GEDCOM object exists, is not null, and does not change while the index is in use
+*@return the new index, NULL on failure.  Must be freed with deleteAncestorIndex.
+*@param obj - a pointer to a GEDCOMobject struct
+**/
+AncestorIndex* createAncestorIndex(const GEDCOMobject* obj);
+
+
+/** Function to free an index made by createAncestorIndex.
+*@param index - pointer to the index, may be NULL
+**/
+void deleteAncestorIndex(AncestorIndex* index);
+
+
+/** Function to find out whether an individual is a direct ancestor of another, at any number of generations.
+*@return true if ancestor is a parent, grandparent and so on of person.  False for the same individual,
+*and for individuals that are not records of the indexed object.
+*@param index - pointer to the index
+*@param ancestor - the possible ancestor
+*@param person - the possible descendant
+**/
+bool isAncestor(const AncestorIndex* index, const Individual* ancestor, const Individual* person);
+
+
+/** Function to find out whether an individual is an ancestor of two others, where a person counts as their own ancestor.
+*@return true if ancestor is first or an ancestor of first, and second or an ancestor of second
+*@param index - pointer to the index
+*@param ancestor - the possible common ancestor
+*@param first - the first person
+*@param second - the second person
+**/
+bool isCommonAncestor(const AncestorIndex* index, const Individual* ancestor, const Individual* first, const Individual* second);
+
+
+/** Function to find out whether two individuals have any common ancestor, where a person counts as their own ancestor.
+* Answered from the labels when one is an ancestor of the other, otherwise by marking the ancestors of
+* the first over the parent edges and walking up from the second until one is found.
+*@return true if they share an ancestor
+*@param index - pointer to the index
+*@param first - the first person
+*@param second - the second person
+**/
+bool haveCommonAncestor(const AncestorIndex* index, const Individual* first, const Individual* second);
+
+#endif
@@ -0,0 +1,113 @@
+/**
+ * @file GEDCOMkinship.h
+ * @brief File containing the function definitions of the kinship and relationship coefficient engine
+ */
+
+#ifndef GEDCOMKINSHIP_H
+#define GEDCOMKINSHIP_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "GEDCOMparser.h"
+#include "GEDCOMgraph.h"
+#include "HashTableAPI.h"
+#include "ArenaAPI.h"
+
+//what computeKinships returns for each pair
+typedef enum {KINSHIP_COEFFICIENT, RELATIONSHIP_COEFFICIENT} kinshipMeasure;
+
+/**
+ * Kinship coefficients that have been worked out, keyed by pair of ids.
+ * Entries live in the arena, so the memo is freed at once.  A memo that has grown past a few million
+ * pairs is emptied before the next pair is worked out.  A pair keeps everything it needs until it is
+ * worked out, which for two people with thousands of ancestors in common can be tens of millions of pairs.
+ **/
+typedef struct kinshipMemo{
+    HashTable pairs;
+    Arena arena;
+} KinshipMemo;
+
+/**
+ * Parents and topological order of every individual of a GEDCOM object.
+ * The father and mother of an individual are the husband and wife of the first family it is a child of,
+ * -1 if unknown.  order puts every individual after its parents, so the kinship of two individuals can
+ * always be worked out from the parents of the one that comes later.  A parent that does not come
+ * before its child, which only happens with broken links, is treated as unknown.
+ * The engine itself is only read once it is made, so any number of threads can share it through
+ * computeKinships.  getKinship and the other single pair functions use the memo in the engine.
+ **/
+typedef struct kinshipEngine{
+    const FamilyGraph* graph;
+
+    //graph built for the engine when the object has none, freed with the engine
+    FamilyGraph* ownGraph;
+
+    int* father;
+    int* mother;
+    int* order;
+
+    KinshipMemo memo;
+} KinshipEngine;
+
+
+/** Function to find the parents and topological order of every individual of a GEDCOM object.
+* The graph the object was loaded with is used if it has one, otherwise one is built for the engine.
+*@pre GEDCOM object exists, is not null, and does not change while the engine is in use
+*@return the new engine, NULL on failure.  Must be freed with deleteKinshipEngine.
+*@param obj - a pointer to a GEDCOMobject struct
+**/
+KinshipEngine* createKinshipEngine(const GEDCOMobject* obj);
+
+
+/** Function to free an engine made by createKinshipEngine, along with its memo.
+*@param engine - pointer to the engine, may be NULL
+**/
+void deleteKinshipEngine(KinshipEngine* engine);
+
+
+/** Function to get the kinship coefficient of two individuals, the chance that an allele taken at random
+* from each of them is identical by descent.  The kinship of an individual with itself is (1 + F) / 2.
+*@return the coefficient, 0 for individuals that are not records of the engine's object
+*@param engine - pointer to the engine, its memo is added to
+*@param first - the first individual
+*@param second - the second individual
+**/
+double getKinship(KinshipEngine* engine, const Individual* first, const Individual* second);
+
+
+/** Function to get the inbreeding coefficient F of an individual, the kinship of its parents.
+*@return the coefficient, 0 if either parent is unknown
+*@param engine - pointer to the engine, its memo is added to
+*@param individual - the individual
+**/
+double getInbreeding(KinshipEngine* engine, const Individual* individual);
+
+
+/** Function to get Wright's coefficient of relationship of two individuals, 2 * kinship / sqrt((1 + F1) * (1 + F2)).
+*@return the coefficient, 0 for individuals that are not records of the engine's object
+*@param engine - pointer to the engine, its memo is added to
+*@param first - the first individual
+*@param second - the second individual
+**/
+double getRelationshipCoefficient(KinshipEngine* engine, const Individual* first, const Individual* second);
+
+
+/** Function to work out a coefficient for many pairs, split over threads.
+* Each thread takes a block of consecutive pairs.  The threads share one memo, split into shards with a
+* lock each, so memory does not grow with the number of threads and a pair one thread has worked out is
+* not worked out again by another.  The engine's own memo is not used or changed.
+*@return true on success, false if the arguments are invalid or memory ran out.  A block a thread could not be
+*started for is worked out on the calling thread.
+*@param engine - pointer to the engine
+*@param first - array of the first individual of each pair
+*@param second - array of the second individual of each pair
+*@param count - number of pairs
+*@param measure - the coefficient to work out
+*@param results - array of count results, in the order of the pairs
+*@param threads - number of threads to use, 0 for one per processor
+**/
+bool computeKinships(const KinshipEngine* engine, const Individual** first, const Individual** second, int count, kinshipMeasure measure, double* results, int threads);
+
+#endif
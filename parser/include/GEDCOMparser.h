@@ -140,6 +140,68 @@ typedef struct {
     
 } GEDCOMerror;
 
+//Loader options for createGEDCOMflags, can be or'd together
+typedef enum lFlag {
+    //Default buffered reader
+    LOAD_DEFAULT = 0,
+
+    //Map the file into memory and parse lines in place.  Best for large files that are not being written to.
+    LOAD_MMAP = 1,
+
+    //Allocate the whole object from one arena, which deleteGEDCOM releases at once.  The object should be
+    //treated as read only, records added to it after loading are not freed by deleteGEDCOM.
+    LOAD_ARENA = 2,
+
+    //Keep a single copy of repeated field tags, surnames and places, shared by every record that uses it.
+    //Implies LOAD_ARENA.
+    LOAD_INTERN = 4,
+
+    //Number the records and build a compressed graph of the family links once loading is done, which the
+    //descendant and ancestor queries then walk instead of the lists.  Implies LOAD_ARENA, as the graph is only
+    //valid while the object does not change.
+    LOAD_GRAPH = 8,
+
+    //Split the file at its records and parse the parts on one thread per processor, then join them in file order.
+    //Gives the same object, errors and string statistics as a single thread.  Implies LOAD_ARENA and LOAD_MMAP.  With
+    //LOAD_INTERN the parts' string pools are joined too, but a string first seen by more than one part leaves an
+    //unused copy in the arena for each part after the first.  Files under a few megabytes are read on one thread.
+    LOAD_PARALLEL = 16
+
+} LoadFlag;
+
+//Memory statistics of a loaded GEDCOM object
+typedef struct {
+
+    //Strings that went through the string pool, and how many of them were different
+    int         strings;
+    int         uniqueStrings;
+
+    //Bytes used by the different strings, and bytes the repeats would have used as separate copies
+    size_t      stringBytes;
+    size_t      savedBytes;
+
+    //Bytes allocated from the object's arena, 0 if it was not loaded into one
+    size_t      arenaBytes;
+
+} GEDCOMstats;
+
+//How two individuals are related, as found by findRelationship
+typedef struct {
+
+    //Nearest common ancestors, the ones with the fewest generations to both people added together.
+    //All objects in the list are const Individual* borrowed from the GEDCOM object.  It is empty if the people are not related.
+    List        ancestors;
+
+    //Individuals from the first person up to the first common ancestor and down to the second person, both ends included.
+    //All objects in the list are const Individual* borrowed from the GEDCOM object.  It is empty if the people are not related.
+    List        path;
+
+    //Generations from each person up to the first common ancestor, -1 if the people are not related
+    int         firstDistance;
+    int         secondDistance;
+
+} Relationship;
+
 
 //***************************************** GEDCOOM object functions *****************************************
 
@@ -158,6 +220,17 @@ typedef struct {
 GEDCOMerror createGEDCOM(char* fileName, GEDCOMobject** obj);
 
 
+/** Function to create a GEDCOM object with non default loader options.
+ *@pre Same as createGEDCOM
+ *@post Same as createGEDCOM
+ *@return the error code indicating success or the error encountered when parsing the GEDCOM
+ *@param fileName - a string containing the name of the GEDCOM file
+ *@param a double pointer to a GEDCOMobject struct that needs to be allocated
+ *@param flags - LoadFlag values or'd together
+ **/
+GEDCOMerror createGEDCOMflags(char* fileName, GEDCOMobject** obj, int flags);
+
+
 /** Function to create a string representation of a GEDCOMobject.
  *@pre GEDCOMobject object exists, is not null, and is valid
  *@post GEDCOMobject has not been modified in any way, and a string representing the GEDCOM contents has been created
@@ -176,6 +249,15 @@ char* printGEDCOM(const GEDCOMobject* obj);
 void deleteGEDCOM(GEDCOMobject* obj);
 
 
+/** Function to get the memory statistics of a GEDCOM object
+ *@pre GEDCOM object exists, is not null, and is valid
+ *@post GEDCOM object has not been modified in any way
+ *@return the statistics.  Only objects loaded with LOAD_INTERN have string statistics, for any other object they are 0.
+ *@param obj - a pointer to a GEDCOMobject struct
+ **/
+GEDCOMstats getGEDCOMstats(const GEDCOMobject* obj);
+
+
 /** Function to "convert" the GEDCOMerror into a humanly redabale string.
  *@return a string contaning a humanly readable representation of the error code
  *@param err - an error struct
@@ -222,6 +304,32 @@ List getDescendants(const GEDCOMobject* familyRecord, const Individual* person);
  **/
 GEDCOMerror writeGEDCOM(char* fileName, const GEDCOMobject* obj);
 
+/** Function to write a GEDCOMobject into a file in GEDCOM format, formatting the records on several threads.
+ *The records are split into parts that the threads format into memory, which are then written in order, so the file
+ *is the same as with one thread.  writeGEDCOM calls this with 0 threads.  Objects of a few thousand records or less
+ *are always written on the calling thread.
+ *@pre Same as writeGEDCOM
+ *@post Same as writeGEDCOM
+ *@return the error code indicating success or the error encountered when writing the file
+ *@param fileName - a string containing the name of the file to write
+ *@param obj - a pointer to a GEDCOMobject struct
+ *@param threads - the most threads to use, 0 for one per processor
+ **/
+GEDCOMerror writeGEDCOMthreads(char* fileName, const GEDCOMobject* obj, int threads);
+
+/** Function to add an individual with just a given name and surname to the end of a GEDCOM file, without rewriting it.
+ *The new INDI record is written over the trailer, followed by a new trailer, so the cost does not depend on the
+ *size of the file apart from one read to pick an unused cross reference.
+ *@pre File exists and is a GEDCOM file that ends with a TRLR record
+ *@post The new record is the last record of the file, nothing before the trailer has been changed
+ *@return the error code indicating success or the error encountered when writing the file.  INV_RECORD if a name
+ *has a line break or '/', or the NAME line would be longer than the 255 characters the parser accepts.
+ *@param fileName - a string containing the name of the GEDCOM file
+ *@param firstname - given name
+ *@param lastname - surname
+ **/
+GEDCOMerror appendIndividual(char* fileName, const char* firstname, const char* lastname);
+
 /** Function for validating an existing GEDCOM object
  *@pre GEDCOM object exists and is not null
  *@post GEDCOM object has not been modified in any way
@@ -249,6 +357,56 @@ List getDescendantListN(const GEDCOMobject* familyRecord, const Individual* pers
  **/
 List getAncestorListN(const GEDCOMobject* familyRecord, const Individual* person, int maxGen);
 
+/** Function to return a list of all descendants of an individual in a GEDCOM, without copying them
+ *@pre GEDCOM object exists, is not null, and is valid
+ *@post GEDCOM object has not been modified in any way, and a list of descendants has been created
+ *@return a list of descendants, in the same order getDescendants returns them.  All list members are const Individual*
+ *pointing at the records in the GEDCOM object, so they are only valid while the object is.  Freeing the list does not free them.
+ *@param familyRecord - a pointer to a GEDCOMobject struct
+ *@param person - the Individual record whose descendants we want
+ **/
+List getDescendantsView(const GEDCOMobject* familyRecord, const Individual* person);
+
+/** Function to return a list of up to N generations of descendants of an individual in a GEDCOM, without copying them
+ *@pre GEDCOM object exists, is not null, and is valid
+ *@post GEDCOM object has not been modified in any way, and a list of descendants has been created
+ *@return a list of generations like getDescendantListN.  The members of each generation are const Individual*
+ *pointing at the records in the GEDCOM object, so they are only valid while the object is.
+ *@param familyRecord - a pointer to a GEDCOMobject struct
+ *@param person - the Individual record whose descendants we want
+ *@param maxGen - maximum number of generations to examine, 0 for all of them
+ **/
+List getDescendantListNView(const GEDCOMobject* familyRecord, const Individual* person, unsigned int maxGen);
+
+/** Function to return a list of up to N generations of ancestors of an individual in a GEDCOM, without copying them
+ *@pre GEDCOM object exists, is not null, and is valid
+ *@post GEDCOM object has not been modified in any way, and a list of ancestors has been created
+ *@return a list of generations like getAncestorListN.  The members of each generation are const Individual*
+ *pointing at the records in the GEDCOM object, so they are only valid while the object is.
+ *@param familyRecord - a pointer to a GEDCOMobject struct
+ *@param person - the Individual record whose ancestors we want
+ *@param maxGen - maximum number of generations to examine, 0 for all of them
+ **/
+List getAncestorListNView(const GEDCOMobject* familyRecord, const Individual* person, int maxGen);
+
+/** Function to find how two individuals in a GEDCOM are related through their common ancestors
+ *A search goes up from each person one generation at a time, always continuing the side with fewer people to look at,
+ *and stops once no closer common ancestor can be found, so the work depends on how far apart the people are rather than on the
+ *size of the tree.  A person counts as their own ancestor, so if one person is an ancestor of the other they are the common ancestor.
+ *@pre GEDCOM object exists, is not null, and is valid
+ *@post GEDCOM object has not been modified in any way
+ *@return the relationship, which must be freed with clearRelationship
+ *@param familyRecord - a pointer to a GEDCOMobject struct
+ *@param first - the first Individual record
+ *@param second - the second Individual record
+ **/
+Relationship findRelationship(const GEDCOMobject* familyRecord, const Individual* first, const Individual* second);
+
+/** Function to free the lists of a Relationship.  The individuals in them belong to the GEDCOM object and are not freed.
+ *@param relationship - a pointer to the Relationship struct
+ **/
+void clearRelationship(Relationship* relationship);
+
 /** Function for converting an Individual struct into a JSON string
  *@pre Individual exists, is not null, and is valid
  *@post Individual has not been modified in any way, and a JSON string has been created
@@ -0,0 +1,126 @@
+/**
+ * @file GEDCOMreader.h
+ * @brief File containing the function definitions of a buffered GEDCOM line reader
+ */
+
+#ifndef GEDCOMREADER_H
+#define GEDCOMREADER_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+//size of a single read() from the file, the buffer grows past it only for longer lines
+#ifndef READER_CHUNK
+#define READER_CHUNK 65536
+#endif
+
+//amount of a mapped file that is read before the pages behind it are given back
+#define READER_RELEASE (8 * 1024 * 1024)
+
+/**
+ * Reader state.
+ * The file is either read in large blocks into buffer, or mapped into memory as a whole
+ * and buffer points at the mapping.  Lines are handed out as slices of the buffer, so no
+ * copy is made for each line.
+ * CR, LF, CRLF and LFCR are all accepted as a line terminator.
+ **/
+typedef struct{
+    int fd;
+    bool mapped;
+
+    //buffer belongs to the caller of createMemoryReader, and is neither released, unmapped nor freed
+    bool borrowed;
+
+    char* buffer;
+    size_t size;
+
+    //unread data is buffer[start] up to buffer[end]
+    size_t start;
+    size_t end;
+    bool eof;
+
+    //where the last line started, for unreadLine
+    size_t lastStart;
+
+    //mapped data before this offset has been given back to the kernel
+    size_t released;
+
+    //number of lines handed out so far
+    int lineNumb;
+
+    //lines joined by readFoldedLine are built here
+    char* fold;
+    size_t foldSize;
+
+    //length of the first line, and its line number, of the last line returned by readFoldedLine
+    size_t firstLength;
+    int foldNumb;
+} GEDCOMreader;
+
+
+/** Function to open a file for reading line by line
+ *@return a new reader, NULL if the file could not be opened
+ *@param fileName - name of the file to read
+ **/
+GEDCOMreader* createReader(char* fileName);
+
+/** Function to open a file for reading line by line through a read-only memory mapping
+ * Slices returned by readLine stay valid until the reader is deleted.
+ * The file must not be truncated while the reader is open.
+ *@return a new reader, NULL if the file could not be opened or mapped
+ *@param fileName - name of the file to read
+ **/
+GEDCOMreader* createMappedReader(char* fileName);
+
+/** Function to read lines out of memory that is already loaded, such as part of a mapped file
+ * Slices returned by readLine point into data and stay valid for as long as it does.
+ *@return a new reader, which has no file of its own
+ *@param data - the characters to read, not nul terminated.  Must not change or go away while the reader is open.
+ *@param size - the number of characters
+ **/
+GEDCOMreader* createMemoryReader(const char* data, size_t size);
+
+/** Function to get the next line of the file
+ *@pre reader exists and is valid
+ *@post the line number has been advanced
+ *@return the line without its terminator.  The slice is NOT nul terminated, use length.  It belongs to
+ *the reader and, unless the reader is mapped, is only valid until the next call to readLine.
+ *NULL once the end of the file is reached.
+ *@param reader - the reader
+ *@param length - set to the length of the line, may be NULL
+ **/
+const char* readLine(GEDCOMreader* reader, size_t* length);
+
+/** Function to get the next GEDCOM line with the CONT and CONC lines after it joined on
+ * Blank lines are skipped.  The line after the last continuation is read ahead and given back with
+ * unreadLine, so the file is only read once and long runs of continuations take linear time.
+ * A CONT value starts on a new line ('\n') while a CONC value is appended directly.
+ *@pre reader exists and is valid
+ *@post foldNumb is the line number the returned line started on
+ *@return the joined line.  The slice is NOT nul terminated, use length.  It is only valid until the next call
+ *to readLine or readFoldedLine.  NULL once the end of the file is reached.
+ *@param reader - the reader
+ *@param length - set to the length of the line, may be NULL
+ **/
+const char* readFoldedLine(GEDCOMreader* reader, size_t* length);
+
+/** Function to give back the line last returned by readLine, so the next readLine returns it again
+ * Only a single line can be given back.
+ *@param reader - the reader
+ **/
+void unreadLine(GEDCOMreader* reader);
+
+/** Function to check if every line of the file has been read
+ *@return true if readLine would return NULL
+ *@param reader - the reader
+ **/
+bool endOfReader(GEDCOMreader* reader);
+
+/** Function to close the file and free the reader
+ *@param reader - the reader
+ **/
+void deleteReader(GEDCOMreader* reader);
+
+#endif
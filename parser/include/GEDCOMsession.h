@@ -0,0 +1,105 @@
+/**
+ * @file GEDCOMsession.h
+ * @brief File containing the function definitions of sessions, GEDCOM files kept open between calls through the shared library
+ */
+
+#ifndef GEDCOMSESSION_H
+#define GEDCOMSESSION_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "GEDCOMparser.h"
+
+/*
+ * A session is a GEDCOM object the library keeps for the caller, named by a small integer handle so it
+ * can be passed through the FFI as an int.  Unlike the cache behind the file name functions, a session
+ * has its own copy of the file, which it can change and write back.  The slot of a closed session is
+ * reused, but its handle is not: a stale handle is reported as invalid rather than naming another file.
+ * All of the functions are thread safe.  Queries of one session run side by side, adding to it or writing
+ * it waits for them, and closing it while calls are using it frees it once the last of them returns.
+ */
+
+
+/** Function to parse a GEDCOM file and keep it open as a session.
+*@return the handle of the session, -1 if the file could not be parsed
+*@param fileName - a string containing the name of the GEDCOM file
+**/
+int openSession(char* fileName);
+
+
+/** Function to free a session.  Changes that were not written are lost.
+*@param session - handle of the session, invalid handles are ignored
+**/
+void closeSession(int session);
+
+
+/** Function to get the object of a session, to use it with the rest of the library.
+* It stays valid until the session is closed, and is not guarded against sessionAddIndividual on other threads.
+*@return the GEDCOM object, NULL for an invalid handle
+*@param session - handle of the session
+**/
+GEDCOMobject* getSessionGEDCOM(int session);
+
+
+/** Function to get the header, submitter and record counts of a session as JSON, like GEDCOMtoJSON.
+*@return newly allocated JSON string, {} for an invalid handle
+*@param session - handle of the session
+**/
+char* sessionSummaryJSON(int session);
+
+
+/** Function to get the individuals of a session as JSON, like createIndJSON.
+*@return newly allocated JSON string, [] for an invalid handle
+*@param session - handle of the session
+**/
+char* sessionIndividualsJSON(int session);
+
+
+/** Function to get up to num generations of descendants of an individual of a session as JSON, like JSONdescendants.
+*@return newly allocated JSON string, [] for an invalid handle
+*@param session - handle of the session
+*@param firstname - given name of the individual
+*@param lastname - surname of the individual
+*@param num - maximum number of generations, 0 for all of them
+**/
+char* sessionDescendantsJSON(int session, char* firstname, char* lastname, int num);
+
+
+/** Function to get up to num generations of ancestors of an individual of a session as JSON, like JSONancestors.
+*@return newly allocated JSON string, [] for an invalid handle
+*@param session - handle of the session
+*@param firstname - given name of the individual
+*@param lastname - surname of the individual
+*@param num - maximum number of generations, 0 for all of them
+**/
+char* sessionAncestorsJSON(int session, char* firstname, char* lastname, int num);
+
+
+/** Function to answer relative queries on a session, like batchJSON.
+*@return newly allocated JSON string, {} for an invalid handle or if a line is not a query
+*@param session - handle of the session
+*@param queries - the queries, one per line as batchToJSON takes them
+*@param threads - number of threads to use, 0 for one per processor
+**/
+char* sessionBatchJSON(int session, char* queries, int threads);
+
+
+/** Function to add an individual with just a given name and surname to a session, like JSONaddindi but without writing the file.
+*@return true if it was added, false for an invalid handle, a name appendIndividual would reject, or no memory
+*@param session - handle of the session
+*@param firstname - given name
+*@param lastname - surname
+**/
+bool sessionAddIndividual(int session, char* firstname, char* lastname);
+
+
+/** Function to write a session to a file, and drop any cached copy of that file.
+*@return the ErrorCode of writeGEDCOM, INV_FILE for an invalid handle
+*@param session - handle of the session
+*@param fileName - name of the file to write, NULL or empty for the file the session was opened from
+**/
+int sessionWrite(int session, char* fileName);
+
+#endif
@@ -0,0 +1,76 @@
+/**
+ * @file GEDCOMstream.h
+ * @brief File containing the function definitions for reading a GEDCOM file as a stream of records and lines
+ */
+
+#ifndef GEDCOMSTREAM_H
+#define GEDCOMSTREAM_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "GEDCOMparser.h"
+
+//struct to hold a piece of a line without copying it, not nul terminated
+typedef struct{
+    const char* start;
+    size_t length;
+} GEDCOMspan;
+
+//struct to hold the pieces of a single GEDCOM line, missing pieces have a NULL start
+typedef struct{
+    int level;
+    GEDCOMspan xref;
+    GEDCOMspan tag;
+    GEDCOMspan value;
+} GEDCOMline;
+
+//kind of record a line belongs to, NO_RECORD for tags the library has no struct for
+typedef enum {NO_RECORD, HEAD_RECORD, INDI_RECORD, FAM_RECORD, SUBM_RECORD} recordType;
+
+/**
+ * Functions streamGEDCOM calls as it reads a file, any of which may be NULL.
+ * The lines they are given point into the reader's buffer and are only valid during the call, so
+ * anything that is kept has to be copied.  Setting the type of error to anything but OK stops the
+ * stream, and streamGEDCOM returns that error.
+ **/
+typedef struct gedcomHandler{
+    //called with the level 0 line that starts each record, the header included, but not the trailer
+    void (*startRecord)(recordType type, const GEDCOMline* line, int lineNumb, GEDCOMerror* error, void* state);
+
+    //called with every line below level 0, with its CONT and CONC lines joined on
+    void (*recordLine)(recordType type, const GEDCOMline* line, int lineNumb, GEDCOMerror* error, void* state);
+
+    //called when a record is over, with the number of the level 0 line after it
+    void (*endRecord)(recordType type, int lineNumb, GEDCOMerror* error, void* state);
+
+    //passed to each of the functions
+    void* state;
+} GEDCOMhandler;
+
+
+/** Function to read a GEDCOM file record by record without building a GEDCOM object.
+ * Memory use does not depend on the size of the file, only on the longest run of continued lines.
+ * The file has to start with a header and end with a trailer, and every line has to have a level and a tag,
+ * with the same error codes createGEDCOM uses.  Checking what the records contain is up to the handler.
+ *@return the error code indicating success or the error encountered when reading the file
+ *@param fileName - a string containing the name of the GEDCOM file
+ *@param handler - the functions to call
+ *@param flags - LOAD_MMAP to map the file instead of reading it in blocks, other LoadFlag values are ignored
+ **/
+GEDCOMerror streamGEDCOM(char* fileName, const GEDCOMhandler* handler, int flags);
+
+
+/** Functions to work with spans
+ * spanEquals/spanPrefix compare against a nul terminated string, spanToString makes a new
+ * nul terminated copy, spanCopy copies into a fixed size array (truncating) and nextToken
+ * works like strtok, taking the next token off the front of rest
+ **/
+bool spanEquals(GEDCOMspan span, const char* str);
+bool spanPrefix(GEDCOMspan span, const char* str);
+char* spanToString(GEDCOMspan span);
+void spanCopy(char* dest, size_t size, GEDCOMspan span);
+GEDCOMspan nextToken(GEDCOMspan* rest, const char* delims);
+
+#endif
@@ -3,6 +3,14 @@
 
 #include "GEDCOMparser.h"
 #include "LinkedListAPI.h"
+#include "HashTableAPI.h"
+#include "GEDCOMreader.h"
+#include "ArenaAPI.h"
+#include "VectorAPI.h"
+#include "SkipListAPI.h"
+#include "GEDCOMgraph.h"
+#include "GEDCOMstream.h"
+#include "GEDCOMwriter.h"
 
 //struct to temporarily hold tag and associated individual
 typedef struct{
@@ -20,20 +28,78 @@ typedef struct{
     Family* temp;
 } storeFam;
 
-/** Function to create submitter recors
- *@return a pointer to the generated submitter record
- *@param char filename
- *@param gedcomerror to report any errors
- *@param token/ should be submitter tag
- **/
-Submitter* createSubmitter(char* fileName, GEDCOMerror* temperror, char* token);
+//bytes appendIndividual reads from the end of a file at a time while it looks for the trailer
+#define APPEND_TAIL 4096
 
-/** Function to check for CONT CONC tags
- *@param char filename
- *@param gedcom file pointer
- *@param current line number
- **/
-void contconcCheck(char* line, FILE* inFile, int* lineNumb, GEDCOMerror* error);
+//kinds of family links that are resolved once the whole file has been read
+typedef enum {HUSB_REF, WIFE_REF, CHIL_REF} refType;
+
+//struct to temporarily hold a family link until its individual is known
+typedef struct{
+    char tag[26];
+    refType type;
+    Family* fam;
+    int line;
+} pendingRef;
+
+//records writeGEDCOM writes, with the numbers they are written with kept by address, as storeIndi and storeFam
+typedef struct{
+    Vector individuals;
+    Vector families;
+    HashTable indiNumbers;
+    HashTable famNumbers;
+} writeRecords;
+
+//string that grows as text is appended to it, text is always nul terminated
+typedef struct{
+    char* text;
+    size_t length;
+    size_t size;
+} growString;
+
+
+//GEDCOM object loaded with LOAD_ARENA, the object comes first so a pointer to it is a pointer to this
+//strings is the string pool keyed by GEDCOMspan, it has no entries unless the object was loaded with LOAD_INTERN
+//graph is NULL unless the object was loaded with LOAD_GRAPH
+typedef struct{
+    GEDCOMobject obj;
+    Arena arena;
+    HashTable strings;
+    GEDCOMstats stats;
+    FamilyGraph* graph;
+} arenaObject;
+
+//struct to hold how a relationship search reached a relative
+typedef struct{
+    Individual* individual;
+    //relative one generation closer to the person the search started from, NULL for that person
+    Individual* from;
+    int distance;
+} relativeStep;
+
+//one of the two searches of findRelationship, reached holds a relativeStep for each individual keyed by the individual
+typedef struct{
+    HashTable reached;
+    Vector frontier;
+    int depth;
+} searchSide;
+
+//struct to hold the state of the single pass loader between lines
+typedef struct{
+    GEDCOMobject* obj;
+    Arena* arena;
+    arenaObject* pool;
+    HashTable xrefTable;
+    List pendingRefs;
+    char submTag[32];
+    bool charCheck;
+    bool inGedc;
+    //record the loader is currently inside of
+    recordType record;
+    Individual* indi;
+    Family* fam;
+    Event* event;
+} parseState;
 
 /** Function to copy an indvidual
  *@return new memory associated with individual
@@ -71,21 +137,11 @@ char* printName(Individual* toBePrinted);
  **/
 bool cmpEvent(Individual* a, const Individual* b);
 
-/** Function to create families for GEDCOM object
- *@param GEDCOM object
- *@param GEDCOM filename
- *@param list of individuals with associated tags
+/** Function to link families to their members once the file has been read
+ *@param loader state holding the individuals keyed by tag and the family references recorded while parsing
  *@param GEDCOMerror to return errors if need be
  **/
-void createFamilies (GEDCOMobject* temp, char* fileName, List tempStore, GEDCOMerror* error);
-
-/** Custom fgets to incorporate GEDCOM standads
- *@return true if sucessfully retrieved GEDCOM line false otherwise
- *@param line to read into from file
- *@param length of line to read, should be 256
- *@param FILE pointer to GEDCOM file
- **/
-bool customFgets(char* line, int len, FILE* inFile, GEDCOMerror* error);
+void createFamilies(parseState* state, GEDCOMerror* error);
 
 /** Compare tags of two individuals
  *@return bool dependant on strcmp of two tags
@@ -105,29 +161,339 @@ void destroyNodeData(void *data);
  **/
 char* tokenize (char line[]);
 
-bool findTag(const void* first,const void* second);
+/** Function to read the next GEDCOM line with its CONT/CONC lines folded in
+ * The pieces point into the reader and are only valid until the next line is read.
+ *@return true if a line was read, false at the end of the file (OTHER_ERROR) or if the line is too long (INV_RECORD)
+ *@param reader for the GEDCOM file
+ *@param GEDCOMline to store the pieces in, the tag is NULL if the line could not be split
+ *@param set to the line number the GEDCOM line started on
+ *@param GEDCOMerror to return errors if need be
+ **/
+bool readGEDCOMline(GEDCOMreader* reader, GEDCOMline* parts, int* lineNumb, GEDCOMerror* error);
+
+/** Function to split a GEDCOM line into level, xref, tag and value without modifying it
+ *@return true if the line has at least a level and a tag
+ *@param line to split
+ *@param length of the line
+ *@param GEDCOMline to store the pieces in
+ **/
+bool splitLine(const char* line, size_t length, GEDCOMline* parts);
+
+/** Functions to write the lines of writeGEDCOM
+ * writeValueLine writes start and then value.  writeXrefLine writes start, a cross reference made of kind and
+ * number with at least width digits, like @I0007@, and then end.  Both finish the line.
+ **/
+void writeValueLine(GEDCOMwriter* writer, const char* start, const char* value);
+void writeXrefLine(GEDCOMwriter* writer, const char* start, char kind, int number, int width, const char* end);
+
+/** Function to write one record of writeGEDCOM, records only read the object and its numbers so any can be written on any thread
+ *@param writer to write to
+ *@param records being written
+ *@param index of the record, individuals come first and then families
+ **/
+void writeRecord(GEDCOMwriter* writer, const writeRecords* records, int index);
+
+/** Function to write every record of writeGEDCOM in order, formatting parts of them on several threads when there are enough
+ * Each part is formatted into a memory writer, and the parts are written to writer one after another.
+ *@return false if a part could not be formatted
+ *@param writer to write to
+ *@param records being written
+ *@param threads - the most threads to use, 0 for one per processor
+ **/
+bool writeRecordsParallel(GEDCOMwriter* writer, const writeRecords* records, int threads);
+
+/** Function to find the largest number of the @I<number>@ record cross references of a GEDCOM file, so appendIndividual can pick a new one
+ *@return the number, -1 if there are none, -2 if the file could not be read
+ *@param fileName - name of the file
+ **/
+int largestIndividualNumber(char* fileName);
+
+/** Function to find the trailer record at the end of a GEDCOM file
+ *@return offset in tail of the line "0 TRLR", -1 if the tail does not end with one
+ *@param tail - the last bytes of the file
+ *@param length - number of bytes in tail
+ *@param eol - set to the line terminator the file uses, if it can be seen around the trailer
+ **/
+long findTrailer(const char* tail, size_t length, const char** eol);
+
+//Keys that are pointers to spans, for looking strings up without copying them
+unsigned long hashSpan(const void* key);
+bool compareSpans(const void* first,const void* second);
+
+/** Functions to build a string of unknown length without rescanning it for every append
+ * The caller owns str.text once it is done.
+ **/
+growString initializeString(void);
+void appendString(growString* str, const char* toAppend);
+
+/** Function to set up the loader state with an empty GEDCOM object
+ *@param state to initialize
+ *@param loader flags, LOAD_ARENA allocates the object from an arena
+ **/
+void initializeParseState(parseState* state, int flags);
+
+/** Delete function for the lists of an arena loaded object, the arena owns the data
+ * deleteGEDCOM also uses it to tell an arena loaded object apart.
+ *@param dummy parameter
+ **/
+void arenaDelete(void* data);
+
+/** Functions to allocate the parts of the object being loaded, from its arena if it has one
+ * parseFree does nothing for arena memory, which is released with the object, and lists made by parseList
+ * use arenaDelete in place of the given delete function.
+ * parseIntern returns the pooled copy of a string when the object has a string pool, and a new one otherwise.
+ **/
+void* parseAlloc(parseState* state, size_t size);
+char* parseString(parseState* state, GEDCOMspan span);
+char* parseIntern(parseState* state, GEDCOMspan span);
+void parseFree(parseState* state, void* data);
+void parseInsert(parseState* state, List* list, void* data);
+List parseList(parseState* state, char* (*printFunction)(void* toBePrinted), void (*deleteFunction)(void* toBeDeleted), int (*compareFunction)(const void* first,const void* second));
+
+/** Function to check the required header fields once the header is over
+ *@return true if source, version, encoding and submitter were all present
+ *@param loader state
+ **/
+bool validateParsedHeader(parseState* state);
+
+/** Function to create a new field from the pieces of a line
+ *@return new memory associated with field
+ *@param loader state the field is allocated for
+ *@param field tag
+ *@param field value
+ **/
+Field* createField(parseState* state, GEDCOMspan tag, GEDCOMspan value);
+
+/** GEDCOMhandler functions createGEDCOM streams a file through, state is the parseState
+ * loadStartRecord starts the struct of each record, loadRecordLine hands each line to the parse function of
+ * the record the loader is in, and loadEndRecord checks the header once it is complete
+ **/
+void loadStartRecord(recordType type, const GEDCOMline* line, int lineNumb, GEDCOMerror* error, void* state);
+void loadRecordLine(recordType type, const GEDCOMline* line, int lineNumb, GEDCOMerror* error, void* state);
+void loadEndRecord(recordType type, int lineNumb, GEDCOMerror* error, void* state);
+
+/** Functions streamGEDCOM is made of, which also read the parts of a file on their own
+ * openStream opens the file, with LOAD_MMAP to map it, and checks that it starts with a header, whose line it sets head to.
+ * streamRecords hands the lines of reader to handler from inside record on, until the trailer, an error or the end of the
+ * reader.  The end of the last part of a file is reported like streamGEDCOM does, any other part just stops there.
+ *@return the reader after the header line, NULL with error set if it could not be opened / the record it stopped in
+ **/
+GEDCOMreader* openStream(char* fileName, int flags, GEDCOMline* head, GEDCOMerror* error);
+recordType streamRecords(GEDCOMreader* reader, const GEDCOMhandler* handler, recordType record, bool last, bool* trailer, GEDCOMerror* error);
+
+/** Function createGEDCOM streams a file through for LOAD_PARALLEL
+ * The header is read into state first, then the rest of the file is split at level 0 lines and each part is parsed
+ * into a state of its own on its own thread.  The parts are joined into state in file order, so tags resolve and
+ * errors are found as they would be by one thread.
+ *@return the error code indicating success or the first error in the file
+ *@param fileName - a string containing the name of the GEDCOM file
+ *@param state - loader state, set up with flags
+ *@param flags - the loader flags
+ **/
+GEDCOMerror streamParallel(char* fileName, parseState* state, int flags);
+
+/** Functions to handle a single line for the loader depending on the current record
+ *@param loader state
+ *@param pieces of the current line
+ *@param current line number
+ *@param GEDCOMerror to return errors if need be
+ **/
+void startRecord(parseState* state, const GEDCOMline* parts, int lineNumb, GEDCOMerror* error);
+void parseHeaderLine(parseState* state, const GEDCOMline* parts, int lineNumb, GEDCOMerror* error);
+void parseSubmitterLine(parseState* state, const GEDCOMline* parts, int lineNumb, GEDCOMerror* error);
+void parseIndividualLine(parseState* state, const GEDCOMline* parts, int lineNumb, GEDCOMerror* error);
+void parseFamilyLine(parseState* state, const GEDCOMline* parts, int lineNumb, GEDCOMerror* error);
+
+/** Function to check if a tag is a family event
+ *@return true if the tag starts a family event
+ *@param tag to check
+ **/
+bool isFamilyEvent(GEDCOMspan tag);
 
-bool findFamily(const void* a,const void* b);
+bool findTag(const void* first,const void* second);
 
 bool findIndividual(const void* a,const void* b);
 
 void getChildren(List *descendants, const Individual *individual, unsigned int maxGen, int count);
 
-void recursiveDescendant(List *descendants, Family *family, unsigned int maxGen, int count);
+/** Function to add a relative to its generation while generations are being collected
+ * Each generation is a SkipList sorted by surname, found by index, until finishGenerations is called.
+ *@param vector of generations, index 0 holds generation 1
+ *@param relative to add, a copy or a record of the GEDCOM object
+ *@param generation to add to, at most one more than the number of generations so far
+ *@param deleteFunction a new generation deletes its relatives with, the same for every relative of a query
+ **/
+void addToGeneration(Vector *generations, Individual *individual, int count, void (*deleteFunction)(void* toBeDeleted));
+
+/** Function to turn the generations collected by addToGeneration into a List of sorted Lists of Individuals
+ *@return the list of generations, in the form getDescendantListN and getAncestorListN return
+ *@param vector of generations, it is left empty
+ **/
+List finishGenerations(Vector *generations);
 
-void recursiveAnscestor(List *descendants, Family *family, unsigned int maxGen, int count);
+/** Function to get the family graph built for an object loaded with LOAD_GRAPH
+ *@return the graph, NULL if the object has none
+ *@param obj - a pointer to a GEDCOMobject struct, may be NULL
+ **/
+const FamilyGraph* getFamilyGraph(const GEDCOMobject* obj);
+
+/** Function to find the families a person is the husband or wife of
+ *@return vector of the families, borrowed from the person
+ *@param person whose families are searched, matched by name
+ *@param checkEvents - true if the events of the person must match as well
+ **/
+Vector adultFamilies(const Individual *person, bool checkEvents);
+
+/** Function to find the families a person is a child of
+ *@return vector of the families, borrowed from the person
+ *@param person whose families are searched
+ **/
+Vector childFamilies(const Individual *person);
+
+/** Function to add the parents of an individual to a vector, from the family graph if the individual is in it
+ *@param graph of the object, may be NULL
+ *@param individual whose parents are added
+ *@param vector the parents are appended to
+ **/
+void addParents(const FamilyGraph *graph, Individual *individual, Vector *parents);
+
+/** Function to start one side of a relationship search
+ *@param side to initialize, freed with clearSearchSide
+ *@param person the side starts from, at distance 0
+ **/
+void initializeSearchSide(searchSide *side, const Individual *person);
+
+/** Function to move one side of a relationship search up one generation, noting the common ancestors it finds
+ *@param graph of the object, may be NULL
+ *@param side to expand
+ *@param other side of the search
+ *@param vector of common ancestors, each new one is appended
+ *@param smallest total distance of a common ancestor so far, -1 if there is none, updated
+ **/
+void expandSearchSide(const FamilyGraph *graph, searchSide *side, searchSide *other, Vector *meetings, int *best);
+
+/** Function to free one side of a relationship search
+ *@param side to free
+ **/
+void clearSearchSide(searchSide *side);
+
+/** Function to add the relatives one family link away that have not been reached yet
+ *@param set of individuals reached so far, the new relatives are added to it
+ *@param vector the new relatives are appended to
+ *@param family to take the relatives from
+ *@param direction, children for descendants and husband and wife for ancestors
+ **/
+void addRelatives(HashTable *visited, Vector *found, Family *family, traverseDirection direction);
+
+/** Function to get the graph ids of the relatives in a person's start families, generation 1 of traverseRelatives
+ *@return newly allocated array of ids, NULL if one of the relatives is not a record of the graph or there is no memory
+ *@param graph of the object the families belong to
+ *@param start - families to take the relatives from
+ *@param direction - children for descendants, husband and wife for ancestors
+ *@param count - set to the number of ids
+ **/
+int *firstGenerationIds(const FamilyGraph *graph, Vector *start, traverseDirection direction, int *count);
+
+/** Function to walk the descendants or ancestors of a person breadth first, one generation at a time
+ * Every relative is visited once, in the nearest generation it can be reached in, so lines that
+ * meet again are not walked twice. The walk uses no recursion. If the object has a family graph
+ * and the person is one of its records, the graph is walked instead of the lists, from the same start families.
+ *@param familyRecord - the object the person belongs to, may be NULL
+ *@param person the walk starts from, never visited itself
+ *@param start - families of the person to start from, generation 1 is the relatives in these
+ *@param direction to walk in
+ *@param maxGen - last generation to visit, 0 for all of them
+ *@param visit - function called with each relative, its generation and state
+ *@param state passed to visit
+ **/
+void traverseRelatives(const GEDCOMobject *familyRecord, const Individual *person, Vector *start, traverseDirection direction, unsigned int maxGen, void (*visit)(Individual *relative, int generation, void *state), void *state);
+
+/** Visit function for traverseRelatives that adds a copy of the relative to a List of Individuals
+ *@param relative that was reached
+ *@param generation of the relative
+ *@param state, a pointer to the List
+ **/
+void collectRelative(Individual *relative, int generation, void *state);
+
+/** Visit function for traverseRelatives that adds a copy of the relative to its generation with addToGeneration
+ *@param relative that was reached
+ *@param generation of the relative
+ *@param state, a pointer to the Vector of generations
+ **/
+void collectGeneration(Individual *relative, int generation, void *state);
+
+/** Visit function for traverseRelatives that adds the relative itself to a List of Individuals
+ *@param relative that was reached
+ *@param generation of the relative
+ *@param state, a pointer to the List
+ **/
+void collectRelativeView(Individual *relative, int generation, void *state);
+
+/** Visit function for traverseRelatives that adds the relative itself to its generation with addToGeneration
+ *@param relative that was reached
+ *@param generation of the relative
+ *@param state, a pointer to the Vector of generations
+ **/
+void collectGenerationView(Individual *relative, int generation, void *state);
 
 int compareSurname(const void* a,const void* b);
 
 bool findIndi(const void* a,const void* b);
 
+/** Compare function for findPerson that matches an individual by given name and surname only
+*@return true if both names are the same
+*@param a - the Individual in the list
+*@param b - an Individual whose names are set, its other fields are not read
+**/
+bool findName(const void* a,const void* b);
+
 char* GEDCOMtoJSON(char* fileName);
 
+/** Function for converting the header, submitter and record counts of a GEDCOM object into the JSON GEDCOMtoJSON returns
+*@return newly allocated JSON string
+*@param gedcomObject - a pointer to a GEDCOMobject struct
+**/
+char* summaryToJSON(const GEDCOMobject* gedcomObject);
+
+/** Function for converting up to num generations of relatives of the individual with the given names into JSON, as gListToJSON does
+*@return newly allocated JSON string, an empty list if there is no such individual
+*@param gedcomObject - a pointer to a GEDCOMobject struct, may be NULL
+*@param firstname - given name of the individual
+*@param lastname - surname of the individual
+*@param num - maximum number of generations, 0 for all of them
+*@param direction - whether to collect descendants or ancestors
+**/
+char* relativesToJSON(const GEDCOMobject* gedcomObject, const char* firstname, const char* lastname, int num, traverseDirection direction);
+
+/** Function to check a name from outside before it goes into a NAME line, as "1 NAME firstname /lastname/"
+*@return false if either name is NULL or has a line break or '/', or the line would be longer than the 255 characters the parser accepts
+*@param firstname - given name
+*@param lastname - surname
+**/
+bool validNewName(const char* firstname, const char* lastname);
+
+/** Function for creating an Individual with just a given name and surname, the way the web front end adds them
+*@return newly allocated Individual, to be freed with deleteIndividual.  NULL if there is no memory for it.
+*@param firstname - given name
+*@param lastname - surname
+**/
+Individual* createNamedIndividual(const char* firstname, const char* lastname);
+
 char* createIndJSON(char* fileName);
 
 char* filterfiles(char* fileName);
 
-void JSONaddindi(char* fileName, char* firstname, char* lastname);
+char* statsToJSON(char* fileName);
+
+char* cacheStatsToJSON(void);
+
+/** Function to add an individual with just a given name and surname to a GEDCOM file with appendIndividual, for the web front end
+*@return the ErrorCode of appendIndividual, OK if the individual was written
+*@param fileName - a string containing the name of the GEDCOM file
+*@param firstname - given name
+*@param lastname - surname
+**/
+int JSONaddindi(char* fileName, char* firstname, char* lastname);
 
 
 #endif
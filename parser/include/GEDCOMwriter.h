@@ -0,0 +1,84 @@
+/**
+ * @file GEDCOMwriter.h
+ * @brief File containing the function definitions of a buffered GEDCOM file writer
+ */
+
+#ifndef GEDCOMWRITER_H
+#define GEDCOMWRITER_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+//size of the buffer, the file is only written to once it is full
+#ifndef WRITER_BUFFER
+#define WRITER_BUFFER (1024 * 1024)
+#endif
+
+/**
+ * Writer state.
+ * Text is gathered in buffer and written out with a single system call each time it fills up.  Text that
+ * does not fit is written together with the buffer rather than copied into it, so long texts cost no copy.
+ * Once a write fails the writer remembers it and drops everything after, closeWriter reports it.
+ **/
+typedef struct{
+    //-1 for a writer made by createMemoryWriter
+    int fd;
+
+    char* buffer;
+    size_t size;
+    size_t used;
+
+    //bytes handed to the file so far
+    size_t written;
+
+    bool failed;
+} GEDCOMwriter;
+
+
+/** Function to create or truncate a file for writing
+ *@return a new writer, NULL if the file could not be opened
+ *@param fileName - name of the file to write
+ **/
+GEDCOMwriter* createWriter(char* fileName);
+
+/** Function to create a writer that keeps everything in memory, for text that is put together before it goes to a file
+ * Its buffer grows to hold all of the text, which is buffer[0] up to buffer[used].  It is never written anywhere.
+ *@return a new writer, NULL if there is no memory for it
+ **/
+GEDCOMwriter* createMemoryWriter(void);
+
+/** Function to add characters to the file
+ *@param writer - the writer
+ *@param text - the characters, not nul terminated
+ *@param length - the number of characters
+ **/
+void writeBytes(GEDCOMwriter* writer, const char* text, size_t length);
+
+/** Function to add a nul terminated string to the file
+ *@param writer - the writer
+ *@param text - the string
+ **/
+void writeText(GEDCOMwriter* writer, const char* text);
+
+/** Function to add a number to the file in decimal, like printf's %0*d
+ *@param writer - the writer
+ *@param number - the number
+ *@param width - the fewest digits to write, leading zeros are added up to it
+ **/
+void writeNumber(GEDCOMwriter* writer, int number, int width);
+
+/** Function to write everything that is buffered to the file
+ *@return false if any write to the file has failed
+ *@param writer - the writer
+ **/
+bool flushWriter(GEDCOMwriter* writer);
+
+/** Function to write what is left, close the file and free the writer, or just free a memory writer
+ *@return false if any write to the file, or closing it, has failed
+ *@param writer - the writer
+ **/
+bool closeWriter(GEDCOMwriter* writer);
+
+#endif
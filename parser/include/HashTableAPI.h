@@ -0,0 +1,98 @@
+/**
+ * @file HashTableAPI.h
+ * @brief File containing the function definitions of an open addressing hash table
+ */
+
+#ifndef _HASH_TABLE_API_
+#define _HASH_TABLE_API_
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+
+/**
+ * Slot of the hash table. A slot with a NULL key is empty.
+ * The key is not copied, it must stay valid for as long as it is in the table
+ * (usually it points into the data stored in the same slot).
+ **/
+typedef struct tableEntry{
+    const void* key;
+    void* data;
+} TableEntry;
+
+/**
+ * Metadata head of the table.
+ * Contains the slot array, which is always a power of two in size, as well as the
+ * function pointers for hashing and comparing keys and for deleting the data.
+ * Collisions are resolved with linear probing.
+ **/
+typedef struct hashTable{
+    TableEntry* entries;
+    int size;
+    int length;
+    unsigned long (*hashKey)(const void* key);
+    bool (*compareKeys)(const void* first,const void* second);
+    void (*deleteData)(void* toBeDeleted);
+} HashTable;
+
+
+/** Function to initialize the table metadata head with the appropriate function pointers.
+*@return the table struct
+*@param expected number of elements, used to size the table so it does not have to grow
+*@param hashFunction function pointer to hash a key
+*@param compareFunction function pointer returning true if two keys are equal
+*@param deleteFunction function pointer to delete a single piece of data from the table
+**/
+HashTable initializeTable(int expected, unsigned long (*hashFunction)(const void* key), bool (*compareFunction)(const void* first,const void* second), void (*deleteFunction)(void* toBeDeleted));
+
+
+/** Inserts data into the table under the given key. The table grows when it becomes 70% full.
+*@pre 'HashTable' type must exist and have been initialized.
+*@post If the key was not in the table, the data can now be found with it
+*@return true if the data was inserted, false if the key was already present (the table is not modified)
+*@param table pointer to the table
+*@param key pointer to the key, must not be NULL
+*@param toBeAdded a pointer to data that is to be added to the table
+**/
+bool insertTable(HashTable* table, const void* key, void* toBeAdded);
+
+
+/** Function that returns the data stored under a key.
+*@pre Table exists and is valid.
+*@post Table remains unchanged.
+*@return The data associated with the key, NULL if the key is not in the table.
+*@param table - a table struct
+*@param key - the key to look for
+**/
+void* lookupTable(HashTable table, const void* key);
+
+
+/** Clears the contents of the table, freeing all memory associated with them.
+* uses the supplied function pointer to release allocated memory for the data.
+* The slot array is released as well, the table must be initialized again before reuse
+*@pre 'HashTable' type must exist and have been initialized.
+*@param table pointer to the table
+**/
+void clearTable(HashTable* table);
+
+
+/**Returns the number of elements in the table.
+ *@param table - the table struct.
+ *@return number of elements in the table (0 or more)
+ **/
+int getTableLength(HashTable table);
+
+
+//****************************************** Common key functions *******************************************
+
+//Keys that are nul terminated strings, e.g. GEDCOM cross reference pointers like @I123@
+unsigned long hashString(const void* key);
+bool compareStrings(const void* first,const void* second);
+
+//Keys that are addresses, e.g. Individual records
+unsigned long hashPointer(const void* key);
+bool comparePointers(const void* first,const void* second);
+
+#endif
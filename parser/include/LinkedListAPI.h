@@ -73,6 +73,16 @@ Node* initializeNode(void* data);
 
 
 
+/**Inserts a node that has already been created at the back of a linked list.  List metadata is updated
+* so that head and tail pointers are correct.  Lets the caller decide where the memory for the node comes from.
+*@pre 'List' type must exist and be used in order to keep track of the linked list.
+*@param list pointer to the dummy head of the list
+*@param newNode node to add, with its data already set
+**/
+void insertNodeBack(List* list, Node* newNode);
+
+
+
 /**Inserts a Node at the front of a linked list.  List metadata is updated
 * so that head and tail pointers are correct.
 *@pre 'List' type must exist and be used in order to keep track of the linked list.
@@ -0,0 +1,124 @@
+/**
+ * @file SkipListAPI.h
+ * @brief File containing the function definitions of a sorted skip list
+ */
+
+#ifndef _SKIP_LIST_API_
+#define _SKIP_LIST_API_
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+#include "LinkedListAPI.h"
+
+//most levels a node can have, enough for far more elements than fit in memory
+#define SKIP_MAX_LEVEL 32
+
+/**
+ * Node of a skip list. next[0] links every node in order, each higher level skips over
+ * roughly half of the nodes of the level below it.
+ **/
+typedef struct skipNode{
+    void* data;
+    int level;
+    struct skipNode* next[];
+} SkipNode;
+
+/**
+ * Metadata head of the skip list.
+ * Elements are kept in the order given by the compare function, so inserting and searching
+ * take O(log n) expected time. Levels are chosen with a generator seeded per list, so the
+ * shape of a list only depends on what was inserted into it.
+ **/
+typedef struct skipList{
+    SkipNode* head;
+    int level;
+    int length;
+    unsigned int seed;
+    void (*deleteData)(void* toBeDeleted);
+    int (*compare)(const void* first,const void* second);
+    char* (*printData)(void* toBePrinted);
+} SkipList;
+
+/**
+ * Skip list iterator structure, visits the elements in sorted order.
+ **/
+typedef struct skipIter{
+    SkipNode* current;
+} SkipListIterator;
+
+
+/** Function to initialize the skip list metadata head with the appropriate function pointers.
+*@return the skip list struct, no memory is reserved until the first insert
+*@param printFunction function pointer to print a single element of the list
+*@param deleteFunction function pointer to delete a single piece of data from the list
+*@param compareFunction function pointer to compare two elements of the list in order to test for equality or order
+**/
+SkipList initializeSkipList(char* (*printFunction)(void* toBePrinted),void (*deleteFunction)(void* toBeDeleted),int (*compareFunction)(const void* first,const void* second));
+
+
+/** Deletes every element of the skip list using the supplied function pointer, freeing all memory.
+* The list is empty afterwards and can be used again.
+*@pre 'SkipList' type must exist and have been initialized.
+*@param list pointer to the skip list
+**/
+void clearSkipList(SkipList* list);
+
+
+/** Uses the comparison function pointer to place the element in order, in O(log n) expected time.
+* Follows the same contract as insertSorted: the element goes immediately before the first element
+* that it compares less than or equal to.
+*@pre 'SkipList' type must exist and have been initialized.
+*@param list pointer to the skip list
+*@param toBeAdded a pointer to data that is to be added to the list
+**/
+void insertSkipSorted(SkipList* list, void* toBeAdded);
+
+
+/** Function that returns the first element that compares equal to the search record, in O(log n) expected time.
+*@return The matching element, NULL if there is none
+*@param list - the skip list struct
+*@param searchRecord - a pointer to search data, compared with the list's compare function
+**/
+void* searchSkipList(SkipList list, const void* searchRecord);
+
+
+/**Returns the number of elements in the skip list.
+ *@param list - the skip list struct.
+ *@return number of elements in the list (0 or more)
+ **/
+int getSkipListLength(SkipList list);
+
+
+/**Returns a string that contains a string representation of the skip list in sorted order,
+ * in the same format toString uses for a List. Returned string must be freed by the calling function.
+ *@param list the skip list struct
+ *@return on success: char * to string representation of the list (must be freed after use).  on failure: NULL
+ **/
+char* skipListToString(SkipList list);
+
+
+/** Function for creating an iterator for the skip list.
+*@return The new iterator, positioned before the first element
+*@param list - the skip list struct
+**/
+SkipListIterator createSkipIterator(SkipList list);
+
+
+/** Function that returns the next element of the skip list through the iterator.
+*@return The next element in sorted order, NULL once the end has been reached
+*@param iter - an iterator to a skip list.
+**/
+void* nextSkipElement(SkipListIterator* iter);
+
+
+/** Function to move every element of the skip list, in sorted order, into a new List with the same function pointers.
+* The skip list is left empty and the list owns the data.
+*@return the new list
+*@param list pointer to the skip list
+**/
+List skipListToList(SkipList* list);
+
+#endif
@@ -0,0 +1,127 @@
+/**
+ * @file VectorAPI.h
+ * @brief File containing the function definitions of a growable array
+ */
+
+#ifndef _VECTOR_API_
+#define _VECTOR_API_
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+#include "LinkedListAPI.h"
+
+/**
+ * Metadata head of the vector.
+ * Holds the elements in one contiguous array that doubles in size when it is full,
+ * as well as the same function pointers a List has for working with the abstracted data.
+ **/
+typedef struct vector{
+    void** data;
+    int length;
+    int capacity;
+    void (*deleteData)(void* toBeDeleted);
+    int (*compare)(const void* first,const void* second);
+    char* (*printData)(void* toBePrinted);
+} Vector;
+
+/**
+ * Vector iterator structure.
+ * Used the same way as a ListIterator, nextVectorElement returns NULL once every element has been seen.
+ **/
+typedef struct vectorIter{
+    void** current;
+    void** end;
+} VectorIterator;
+
+
+/** Function to initialize the vector metadata head with the appropriate function pointers.
+*@return the vector struct, with no memory reserved yet
+*@param printFunction function pointer to print a single element of the vector
+*@param deleteFunction function pointer to delete a single piece of data from the vector
+*@param compareFunction function pointer to compare two elements of the vector in order to test for equality or order
+**/
+Vector initializeVector(char* (*printFunction)(void* toBePrinted),void (*deleteFunction)(void* toBeDeleted),int (*compareFunction)(const void* first,const void* second));
+
+
+/** Deletes every element of the vector using the supplied function pointer and releases the array.
+* The vector is empty afterwards and can be used again.
+*@pre 'Vector' type must exist and have been initialized.
+*@param vector pointer to the vector
+**/
+void clearVector(Vector* vector);
+
+
+/** Makes room for at least the given number of elements, so that many can be added without the array moving.
+*@pre 'Vector' type must exist and have been initialized.
+*@param vector pointer to the vector
+*@param capacity number of elements to make room for
+**/
+void reserveVector(Vector* vector, int capacity);
+
+
+/** Adds an element after the last element of the vector. Amortized constant time.
+*@pre 'Vector' type must exist and have been initialized.
+*@param vector pointer to the vector
+*@param toBeAdded a pointer to data that is to be added to the vector
+**/
+void insertBackVector(Vector* vector, void* toBeAdded);
+
+
+/** Returns the element at an index. Does not alter the vector.
+*@return pointer to the data, NULL if the index is out of range
+*@param vector the vector struct
+*@param index index of the element, starting at 0
+**/
+void* getVectorElement(Vector vector, int index);
+
+
+/**Returns the number of elements in the vector.
+ *@param vector - the vector struct.
+ *@return number of elements in the vector (0 or more)
+ **/
+int getVectorLength(Vector vector);
+
+
+/**Returns a string that contains a string representation of the vector from first to last element,
+ * in the same format toString uses for a List. Returned string must be freed by the calling function.
+ *@param vector the vector struct
+ *@return on success: char * to string representation of vector (must be freed after use).  on failure: NULL
+ **/
+char* vectorToString(Vector vector);
+
+
+/** Function that returns the first element matching the search record, using the same contract as findElement.
+*@return The data associated with the element that matches the search record, NULL if there is none
+*@param vector - the vector struct
+*@param customCompare - a pointer to comparator fuction for customizing the search
+*@param searchRecord - a pointer to search data, which contains seach criteria
+**/
+void* findVectorElement(Vector vector, bool (*customCompare)(const void* first,const void* second), const void* searchRecord);
+
+
+/** Function for creating an iterator for the vector.
+*@return The new iterator, positioned before the first element
+*@param vector - the vector struct
+**/
+VectorIterator createVectorIterator(Vector vector);
+
+
+/** Function that returns the next element of the vector through the iterator.
+*@return The next element, NULL once the end has been reached
+*@param iter - an iterator to a vector.
+**/
+void* nextVectorElement(VectorIterator* iter);
+
+
+/** Function to copy the element pointers of a list into a new vector, in the same order.
+* The vector borrows the data: it has the list's print and compare functions, but clearVector only
+* releases the array and the data stays owned by the list.
+*@return the new vector
+*@param list - the list struct
+**/
+Vector listToVector(List list);
+
+#endif
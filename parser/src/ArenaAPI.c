@@ -0,0 +1,157 @@
+#include "ArenaAPI.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+Arena initializeArena(void){
+    Arena tmpArena;
+
+    tmpArena.head = NULL;
+    tmpArena.blockSize = ARENA_MIN_BLOCK;
+    tmpArena.allocated = 0;
+
+    return tmpArena;
+}
+
+/** Function to find room for an allocation in a block
+*@return offset into the block's data that is aligned, or the block size if it does not fit
+*@param block the block to look in
+*@param size number of bytes needed
+*@param align alignment of the memory, a power of two
+**/
+static size_t fitBlock(ArenaBlock* block, size_t size, size_t align){
+    uintptr_t base = (uintptr_t)block->data;
+    size_t offset = ((base + block->used + align - 1) & ~(uintptr_t)(align - 1)) - base;
+
+    if(offset > block->size || size > block->size - offset){
+        return block->size;
+    }
+
+    return offset;
+}
+
+/** Function to hand out memory from the newest block, starting a new block if it is full.
+*@return pointer to the memory
+*@param arena pointer to the arena
+*@param size number of bytes needed
+*@param align alignment of the memory, a power of two
+**/
+static void* allocate(Arena* arena, size_t size, size_t align){
+    ArenaBlock* block = arena->head;
+
+    if(block != NULL){
+        size_t offset = fitBlock(block, size, align);
+        if(offset != block->size){
+            block->used = offset + size;
+            arena->allocated += size;
+            return block->data + offset;
+        }
+    }
+
+    //oversized requests get a block of their own
+    size_t blockSize = arena->blockSize;
+    bool oversized = size + align > blockSize;
+    if(oversized){
+        blockSize = size + align;
+    }
+    else if(arena->blockSize < ARENA_MAX_BLOCK){
+        arena->blockSize *= 2;
+    }
+
+    block = malloc(sizeof(ArenaBlock) + blockSize);
+    if(block == NULL){
+        return NULL;
+    }
+    block->size = blockSize;
+    block->used = 0;
+
+    //a block that was made for one request is full already, so the newest block keeps being used
+    if(oversized && arena->head != NULL){
+        block->next = arena->head->next;
+        arena->head->next = block;
+    }
+    else{
+        block->next = arena->head;
+        arena->head = block;
+    }
+
+    size_t offset = fitBlock(block, size, align);
+    block->used = offset + size;
+    arena->allocated += size;
+
+    return block->data + offset;
+}
+
+void* arenaAlloc(Arena* arena, size_t size){
+    if(arena == NULL){
+        return NULL;
+    }
+
+    return allocate(arena, size, _Alignof(max_align_t));
+}
+
+char* arenaString(Arena* arena, const char* str, size_t length){
+    if(arena == NULL){
+        return NULL;
+    }
+
+    char* copy = allocate(arena, length + 1, 1);
+    if(copy == NULL){
+        return NULL;
+    }
+    if(length > 0){
+        memcpy(copy, str, length);
+    }
+    copy[length] = '\0';
+
+    return copy;
+}
+
+void mergeArena(Arena* into, Arena* from){
+    if(into == NULL || from == NULL || into == from || from->head == NULL){
+        return;
+    }
+
+    //the blocks of from go behind the newest block of into, which may still have room
+    ArenaBlock* tail = from->head;
+    while(tail->next != NULL){
+        tail = tail->next;
+    }
+
+    if(into->head == NULL){
+        into->head = from->head;
+    }
+    else{
+        tail->next = into->head->next;
+        into->head->next = from->head;
+    }
+    into->allocated += from->allocated;
+
+    from->head = NULL;
+    from->blockSize = ARENA_MIN_BLOCK;
+    from->allocated = 0;
+}
+
+void clearArena(Arena* arena){
+    if(arena == NULL){
+        return;
+    }
+
+    ArenaBlock* block = arena->head;
+    while(block != NULL){
+        ArenaBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+
+    arena->head = NULL;
+    arena->blockSize = ARENA_MIN_BLOCK;
+    arena->allocated = 0;
+}
+
+size_t getArenaSize(Arena arena){
+    return arena.allocated;
+}
@@ -0,0 +1,254 @@
+#define _DEFAULT_SOURCE
+
+#include "GEDCOMbatch.h"
+#include "GEDCOMutilities.h"
+#include "GEDCOMcache.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+//queries shared by the threads of runRelativeQueries
+typedef struct{
+    const GEDCOMobject* obj;
+    const RelativeQuery* queries;
+    RelativeResult* results;
+    int count;
+    //index of the next query nobody has taken
+    atomic_int next;
+} queryPool;
+
+/** Function to read a monotonic clock
+*@return the time in seconds
+**/
+static double currentSeconds(void){
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/** Function run by each thread of runRelativeQueries, answers queries until there are none left
+*@return NULL
+*@param data - pointer to the queryPool
+**/
+static void* queryWorker(void* data){
+    queryPool* pool = (queryPool*)data;
+
+    int i;
+    while((i = atomic_fetch_add(&pool->next, 1)) < pool->count){
+        const RelativeQuery* query = &pool->queries[i];
+        double start = currentSeconds();
+
+        if(query->direction == ANCESTOR_LINKS){
+            pool->results[i].generations = getAncestorListNView(pool->obj, query->person, (int)query->maxGen);
+        }
+        else{
+            pool->results[i].generations = getDescendantListNView(pool->obj, query->person, query->maxGen);
+        }
+
+        pool->results[i].seconds = currentSeconds() - start;
+    }
+
+    return NULL;
+}
+
+bool runRelativeQueries(const GEDCOMobject* obj, const RelativeQuery* queries, int count, RelativeResult* results, int threads){
+    if(obj == NULL || queries == NULL || results == NULL || count < 0){
+        return false;
+    }
+
+    if(threads <= 0){
+        long processors = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = processors > 0 ? (int)processors : 1;
+    }
+    if(threads > count){
+        threads = count > 0 ? count : 1;
+    }
+
+    pthread_t* ids = malloc(sizeof(pthread_t) * threads);
+    bool* started = malloc(sizeof(bool) * threads);
+    if(ids == NULL || started == NULL){
+        free(ids);
+        free(started);
+        return false;
+    }
+
+    queryPool pool;
+    pool.obj = obj;
+    pool.queries = queries;
+    pool.results = results;
+    pool.count = count;
+    atomic_init(&pool.next, 0);
+
+    //the calling thread is one of the pool, a thread that could not be started just leaves more for the others
+    for(int t = 0; t < threads - 1; t++){
+        started[t] = pthread_create(&ids[t], NULL, &queryWorker, &pool) == 0;
+    }
+    queryWorker(&pool);
+
+    for(int t = 0; t < threads - 1; t++){
+        if(started[t]){
+            pthread_join(ids[t], NULL);
+        }
+    }
+
+    free(ids);
+    free(started);
+
+    return true;
+}
+
+void clearRelativeResults(RelativeResult* results, int count){
+    if(results == NULL){
+        return;
+    }
+
+    for(int i = 0; i < count; i++){
+        clearList(&results[i].generations);
+        results[i].seconds = 0;
+    }
+}
+
+/** Function to read one line of the queries of batchToJSON, the line is split up in place
+*@return false if the line is not a query
+*@param obj - the object to find the individual in
+*@param line - the line, without its line terminator
+*@param query - set to the query
+**/
+static bool readQuery(const GEDCOMobject* obj, char* line, RelativeQuery* query){
+    //fields are split by hand rather than with strtok, which would skip the empty surname of a tab at the end
+    char* fields[4];
+    fields[0] = line;
+    for(int i = 1; i < 4; i++){
+        char* tab = strchr(fields[i - 1], '\t');
+        if(tab == NULL){
+            return false;
+        }
+        *tab = '\0';
+        fields[i] = tab + 1;
+    }
+    if(strchr(fields[3], '\t') != NULL){
+        return false;
+    }
+
+    if(strcmp(fields[0], "ancestors") == 0){
+        query->direction = ANCESTOR_LINKS;
+    }
+    else if(strcmp(fields[0], "descendants") == 0){
+        query->direction = DESCENDANT_LINKS;
+    }
+    else{
+        return false;
+    }
+
+    char* end;
+    long maxGen = strtol(fields[1], &end, 10);
+    if(end == fields[1] || *end != '\0' || maxGen < 0 || maxGen > INT_MAX){
+        return false;
+    }
+    query->maxGen = (unsigned int)maxGen;
+
+    Individual name;
+    name.givenName = fields[2];
+    name.surname = fields[3];
+    query->person = findPerson(obj, &findName, &name);
+
+    return true;
+}
+
+char* batchToJSON(const GEDCOMobject* obj, const char* queries, int threads){
+    growString str = initializeString();
+    if(obj == NULL || queries == NULL){
+        appendString(&str, "{}");
+        return str.text;
+    }
+
+    double start = currentSeconds();
+
+    //there is at most one query per line
+    int lines = 1;
+    for(const char* c = queries; *c != '\0'; c++){
+        if(*c == '\n'){
+            lines++;
+        }
+    }
+
+    char* text = malloc(sizeof(char) * (strlen(queries) + 1));
+    RelativeQuery* list = malloc(sizeof(RelativeQuery) * lines);
+    RelativeResult* results = malloc(sizeof(RelativeResult) * lines);
+    bool valid = text != NULL && list != NULL && results != NULL;
+
+    int count = 0;
+    char* line = valid ? strcpy(text, queries) : NULL;
+    while(valid && line != NULL){
+        char* next = strchr(line, '\n');
+        if(next != NULL){
+            *next = '\0';
+            next++;
+        }
+
+        size_t length = strlen(line);
+        if(length > 0 && line[length - 1] == '\r'){
+            line[--length] = '\0';
+        }
+        if(length > 0){
+            valid = readQuery(obj, line, &list[count]);
+            count++;
+        }
+
+        line = next;
+    }
+
+    if(valid){
+        valid = runRelativeQueries(obj, list, count, results, threads);
+    }
+    if(!valid){
+        free(text);
+        free(list);
+        free(results);
+        appendString(&str, "{}");
+        return str.text;
+    }
+
+    //the batch is timed up to the last answer, putting them into JSON is not part of it
+    char number[64];
+    sprintf(number, "{\"seconds\":%.6f,\"results\":[", currentSeconds() - start);
+    appendString(&str, number);
+    for(int i = 0; i < count; i++){
+        sprintf(number, "%s{\"seconds\":%.6f,\"generations\":", i == 0 ? "" : ",", results[i].seconds);
+        appendString(&str, number);
+
+        char* generations = gListToJSON(results[i].generations);
+        appendString(&str, generations);
+        free(generations);
+
+        appendString(&str, "}");
+    }
+    appendString(&str, "]}");
+
+    clearRelativeResults(results, count);
+    free(text);
+    free(list);
+    free(results);
+
+    return str.text;
+}
+
+char* batchJSON(char* fileName, char* queries, int threads){
+    GEDCOMhandle* handle = acquireGEDCOM(fileName, NULL);
+    if(handle == NULL){
+        return batchToJSON(NULL, queries, threads);
+    }
+
+    //the answers point at the cached records, so they are serialized before the handle is released
+    char* toReturn = batchToJSON(getCachedGEDCOM(handle), queries, threads);
+    releaseGEDCOM(handle);
+
+    return toReturn;
+}
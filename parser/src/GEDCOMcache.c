@@ -0,0 +1,310 @@
+#define _DEFAULT_SOURCE
+
+#include "GEDCOMcache.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef __APPLE__
+#define st_mtim st_mtimespec
+#endif
+
+struct gedcomCacheEntry{
+    char* path;
+    struct timespec mtime;
+    off_t size;
+
+    GEDCOMobject* obj;
+    size_t bytes;
+
+    //handles given out and not yet released
+    int users;
+
+    //false once the entry is dropped, it is then freed by the last release
+    bool cached;
+
+    //true while the file is parsed outside of cacheLock, obj is NULL until then and stays NULL if it failed
+    bool loading;
+    GEDCOMerror error;
+
+    //neighbours in the cache, newest first
+    struct gedcomCacheEntry* newer;
+    struct gedcomCacheEntry* older;
+};
+
+//cached files, the few a process keeps open are found by walking them from the most recently used
+static GEDCOMhandle* newest = NULL;
+static GEDCOMhandle* oldest = NULL;
+static GEDCOMcacheStats counters = {0, 0, 0, 0, 0, 0, GEDCOM_CACHE_BUDGET};
+static pthread_mutex_t cacheLock = PTHREAD_MUTEX_INITIALIZER;
+//signalled whenever an entry finishes loading
+static pthread_cond_t cacheLoaded = PTHREAD_COND_INITIALIZER;
+
+/** Function to free an entry along with its object
+*@param entry - the entry, no longer in the cache
+**/
+static void freeEntry(GEDCOMhandle* entry){
+    deleteGEDCOM(entry->obj);
+    free(entry->path);
+    free(entry);
+}
+
+/** Function to take an entry out of the order of the cache, without dropping it
+*@param entry - the entry
+**/
+static void unlinkEntry(GEDCOMhandle* entry){
+    if(entry->newer != NULL){
+        entry->newer->older = entry->older;
+    }
+    else{
+        newest = entry->older;
+    }
+    if(entry->older != NULL){
+        entry->older->newer = entry->newer;
+    }
+    else{
+        oldest = entry->newer;
+    }
+
+    entry->newer = NULL;
+    entry->older = NULL;
+}
+
+/** Function to put an entry at the front of the cache, as the most recently used
+*@param entry - the entry, not linked
+**/
+static void pushEntry(GEDCOMhandle* entry){
+    entry->newer = NULL;
+    entry->older = newest;
+    if(newest != NULL){
+        newest->newer = entry;
+    }
+    else{
+        oldest = entry;
+    }
+    newest = entry;
+}
+
+/** Function to drop an entry from the cache, freeing it unless it is in use
+*@param entry - the entry, in the cache
+**/
+static void dropEntry(GEDCOMhandle* entry){
+    unlinkEntry(entry);
+    entry->cached = false;
+    counters.entries--;
+    counters.bytes -= entry->bytes;
+
+    if(entry->users == 0){
+        freeEntry(entry);
+    }
+}
+
+/** Function to drop the least recently used entries that are not in use until the cache fits its budget
+**/
+static void trimCache(void){
+    GEDCOMhandle* entry = oldest;
+
+    while(entry != NULL && counters.bytes > counters.budget){
+        GEDCOMhandle* newer = entry->newer;
+        if(entry->users == 0){
+            dropEntry(entry);
+            counters.evictions++;
+        }
+        entry = newer;
+    }
+}
+
+GEDCOMhandle* acquireGEDCOM(const char* fileName, GEDCOMerror* error){
+    GEDCOMerror result;
+    result.type = OK;
+    result.line = -1;
+
+    struct stat info;
+    if(fileName == NULL || stat(fileName, &info) != 0){
+        result.type = INV_FILE;
+        if(error != NULL){
+            *error = result;
+        }
+        return NULL;
+    }
+
+    pthread_mutex_lock(&cacheLock);
+
+    GEDCOMhandle* entry = newest;
+    while(entry != NULL && strcmp(entry->path, fileName) != 0){
+        entry = entry->older;
+    }
+
+    //a file that changed since it was parsed has to be parsed again
+    if(entry != NULL && (entry->size != info.st_size || entry->mtime.tv_sec != info.st_mtim.tv_sec || entry->mtime.tv_nsec != info.st_mtim.tv_nsec)){
+        dropEntry(entry);
+        counters.invalidations++;
+        entry = NULL;
+    }
+
+    //a file another call is parsing is waited for, files other calls want are not held up by it
+    if(entry != NULL && entry->loading){
+        entry->users++;
+        while(entry->loading){
+            pthread_cond_wait(&cacheLoaded, &cacheLock);
+        }
+
+        if(entry->obj == NULL){
+            result = entry->error;
+            entry->users--;
+            if(entry->users == 0){
+                freeEntry(entry);
+            }
+            pthread_mutex_unlock(&cacheLock);
+
+            if(error != NULL){
+                *error = result;
+            }
+            return NULL;
+        }
+        entry->users--;
+    }
+
+    if(entry != NULL){
+        counters.hits++;
+        entry->users++;
+        if(entry->cached){
+            unlinkEntry(entry);
+            pushEntry(entry);
+        }
+        pthread_mutex_unlock(&cacheLock);
+
+        if(error != NULL){
+            *error = result;
+        }
+        return entry;
+    }
+
+    counters.misses++;
+
+    //the loader takes a mutable name, and keeps it no longer than the call
+    entry = calloc(1, sizeof(GEDCOMhandle));
+    char* path = malloc(strlen(fileName) + 1);
+    if(entry == NULL || path == NULL){
+        free(entry);
+        free(path);
+        pthread_mutex_unlock(&cacheLock);
+        result.type = OTHER_ERROR;
+        if(error != NULL){
+            *error = result;
+        }
+        return NULL;
+    }
+    strcpy(path, fileName);
+
+    //the entry is in the cache while it loads, so other calls for the file wait for it instead of parsing it too
+    entry->path = path;
+    entry->mtime = info.st_mtim;
+    entry->size = info.st_size;
+    entry->users = 1;
+    entry->cached = true;
+    entry->loading = true;
+    pushEntry(entry);
+    counters.entries++;
+
+    pthread_mutex_unlock(&cacheLock);
+
+    GEDCOMobject* obj = NULL;
+    result = createGEDCOMflags(path, &obj, LOAD_INTERN | LOAD_GRAPH);
+
+    pthread_mutex_lock(&cacheLock);
+
+    entry->loading = false;
+    entry->error = result;
+    if(result.type != OK){
+        //dropped, but the calls waiting for it still read the error before the last of them frees it
+        if(entry->cached){
+            unlinkEntry(entry);
+            entry->cached = false;
+            counters.entries--;
+        }
+        entry->users--;
+        if(entry->users == 0){
+            freeEntry(entry);
+        }
+        entry = NULL;
+    }
+    else{
+        entry->obj = obj;
+        entry->bytes = getGEDCOMstats(obj).arenaBytes;
+        //invalidateGEDCOM may have dropped it while it loaded, then it is only kept for the calls using it
+        if(entry->cached){
+            counters.bytes += entry->bytes;
+            trimCache();
+        }
+    }
+    pthread_cond_broadcast(&cacheLoaded);
+
+    pthread_mutex_unlock(&cacheLock);
+
+    if(error != NULL){
+        *error = result;
+    }
+    return entry;
+}
+
+const GEDCOMobject* getCachedGEDCOM(const GEDCOMhandle* handle){
+    return handle == NULL ? NULL : handle->obj;
+}
+
+void releaseGEDCOM(GEDCOMhandle* handle){
+    if(handle == NULL){
+        return;
+    }
+
+    pthread_mutex_lock(&cacheLock);
+
+    handle->users--;
+    if(!handle->cached){
+        if(handle->users == 0){
+            freeEntry(handle);
+        }
+    }
+    else{
+        trimCache();
+    }
+
+    pthread_mutex_unlock(&cacheLock);
+}
+
+void invalidateGEDCOM(const char* fileName){
+    pthread_mutex_lock(&cacheLock);
+
+    GEDCOMhandle* entry = newest;
+    while(entry != NULL){
+        GEDCOMhandle* older = entry->older;
+        if(fileName == NULL || strcmp(entry->path, fileName) == 0){
+            dropEntry(entry);
+            counters.invalidations++;
+        }
+        entry = older;
+    }
+
+    pthread_mutex_unlock(&cacheLock);
+}
+
+void setGEDCOMcacheBudget(size_t bytes){
+    pthread_mutex_lock(&cacheLock);
+
+    counters.budget = bytes;
+    trimCache();
+
+    pthread_mutex_unlock(&cacheLock);
+}
+
+GEDCOMcacheStats getGEDCOMcacheStats(void){
+    pthread_mutex_lock(&cacheLock);
+    GEDCOMcacheStats stats = counters;
+    pthread_mutex_unlock(&cacheLock);
+
+    return stats;
+}
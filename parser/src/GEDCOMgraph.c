@@ -0,0 +1,485 @@
+#include "GEDCOMgraph.h"
+#include "GEDCOMutilities.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <limits.h>
+
+/** Function to append the edges of one individual to an edge array, or only count them.
+*@return number of edges of the individual
+*@param graph - pointer to the graph, with every record numbered
+*@param individual - the individual whose families are followed
+*@param children - true for the child edges, false for the parent edges
+*@param edges - array to write the edges to, NULL to only count them
+**/
+static int addEdges(const FamilyGraph* graph, Individual* individual, bool children, int* edges){
+    int count = 0;
+
+    ListIterator iter = createIterator(individual->families);
+    while(iter.current != NULL){
+        Family* family = (Family*)iter.current->data;
+        bool adult = family->wife == individual || family->husband == individual;
+
+        if(adult && children){
+            ListIterator childIter = createIterator(family->children);
+            while(childIter.current != NULL){
+                int id = getIndividualId(graph, (Individual*)childIter.current->data);
+                if(id >= 0){
+                    if(edges != NULL){
+                        edges[count] = id;
+                    }
+                    count++;
+                }
+                nextElement(&childIter);
+            }
+        }
+        else if(!adult && !children){
+            Individual* parents[2] = {family->husband, family->wife};
+            for(int i = 0; i < 2; i++){
+                int id = parents[i] == NULL ? -1 : getIndividualId(graph, parents[i]);
+                if(id >= 0){
+                    if(edges != NULL){
+                        edges[count] = id;
+                    }
+                    count++;
+                }
+            }
+        }
+        nextElement(&iter);
+    }
+
+    return count;
+}
+
+/** Function to build one compressed edge array, counting the edges first so it is allocated once.
+*@return true on success
+*@param graph - pointer to the graph, with every record numbered
+*@param children - true for the child edges, false for the parent edges
+*@param start - set to the array of where the edges of each individual start
+*@param edges - set to the array of edges
+**/
+static bool buildEdges(FamilyGraph* graph, bool children, int** start, int** edges){
+    *start = malloc(sizeof(int) * (graph->individualCount + 1));
+    if(*start == NULL){
+        return false;
+    }
+
+    (*start)[0] = 0;
+    for(int i = 0; i < graph->individualCount; i++){
+        (*start)[i + 1] = (*start)[i] + addEdges(graph, graph->individuals[i], children, NULL);
+    }
+
+    //one extra slot so a graph with no edges still has an array
+    *edges = malloc(sizeof(int) * ((*start)[graph->individualCount] + 1));
+    if(*edges == NULL){
+        return false;
+    }
+
+    for(int i = 0; i < graph->individualCount; i++){
+        addEdges(graph, graph->individuals[i], children, *edges + (*start)[i]);
+    }
+
+    return true;
+}
+
+FamilyGraph* createFamilyGraph(const GEDCOMobject* obj){
+    if(obj == NULL){
+        return NULL;
+    }
+
+    FamilyGraph* graph = calloc(1, sizeof(FamilyGraph));
+    if(graph == NULL){
+        return NULL;
+    }
+
+    graph->individualCount = getLength(obj->individuals);
+    graph->familyCount = getLength(obj->families);
+    graph->individuals = malloc(sizeof(Individual*) * (graph->individualCount + 1));
+    graph->families = malloc(sizeof(Family*) * (graph->familyCount + 1));
+    //the data of the id tables points into the graph's arrays, which are freed on their own
+    graph->individualIds = initializeTable(graph->individualCount, &hashPointer, &comparePointers, &dummyDelete);
+    graph->familyIds = initializeTable(graph->familyCount, &hashPointer, &comparePointers, &dummyDelete);
+    if(graph->individuals == NULL || graph->families == NULL){
+        deleteFamilyGraph(graph);
+        return NULL;
+    }
+
+    int id = 0;
+    ListIterator iter = createIterator(obj->individuals);
+    while(iter.current != NULL){
+        graph->individuals[id] = (Individual*)iter.current->data;
+        insertTable(&graph->individualIds, graph->individuals[id], &graph->individuals[id]);
+        id++;
+        nextElement(&iter);
+    }
+
+    id = 0;
+    iter = createIterator(obj->families);
+    while(iter.current != NULL){
+        graph->families[id] = (Family*)iter.current->data;
+        insertTable(&graph->familyIds, graph->families[id], &graph->families[id]);
+        id++;
+        nextElement(&iter);
+    }
+
+    if(!buildEdges(graph, true, &graph->childStart, &graph->childIds) ||
+        !buildEdges(graph, false, &graph->parentStart, &graph->parentIds)){
+        deleteFamilyGraph(graph);
+        return NULL;
+    }
+
+    return graph;
+}
+
+void deleteFamilyGraph(FamilyGraph* graph){
+    if(graph == NULL){
+        return;
+    }
+
+    clearTable(&graph->individualIds);
+    clearTable(&graph->familyIds);
+    free(graph->individuals);
+    free(graph->families);
+    free(graph->childStart);
+    free(graph->childIds);
+    free(graph->parentStart);
+    free(graph->parentIds);
+    free(graph);
+}
+
+int getIndividualId(const FamilyGraph* graph, const Individual* individual){
+    Individual** slot = (Individual**)lookupTable(graph->individualIds, individual);
+
+    return slot == NULL ? -1 : (int)(slot - graph->individuals);
+}
+
+int getFamilyId(const FamilyGraph* graph, const Family* family){
+    Family** slot = (Family**)lookupTable(graph->familyIds, family);
+
+    return slot == NULL ? -1 : (int)(slot - graph->families);
+}
+
+void traverseGraph(const FamilyGraph* graph, int id, const int* first, int firstCount, traverseDirection direction, unsigned int maxGen, void (*visit)(Individual* relative, int generation, void* state), void* state){
+    if(graph == NULL || id < 0 || id >= graph->individualCount){
+        return;
+    }
+
+    const int* start = direction == DESCENDANT_LINKS ? graph->childStart : graph->parentStart;
+    const int* edges = direction == DESCENDANT_LINKS ? graph->childIds : graph->parentIds;
+
+    //every individual is queued at most once, so the queue never holds more than all of them
+    uint64_t* visited = calloc(graph->individualCount / 64 + 1, sizeof(uint64_t));
+    int* queue = malloc(sizeof(int) * graph->individualCount);
+    if(visited == NULL || queue == NULL){
+        free(visited);
+        free(queue);
+        return;
+    }
+
+    if(first == NULL){
+        first = edges + start[id];
+        firstCount = start[id + 1] - start[id];
+    }
+
+    visited[id / 64] |= (uint64_t)1 << (id % 64);
+    int head = 0;
+    int tail = 0;
+    for(int i = 0; i < firstCount; i++){
+        int next = first[i];
+        if(next >= 0 && next < graph->individualCount && !(visited[next / 64] & ((uint64_t)1 << (next % 64)))){
+            visited[next / 64] |= (uint64_t)1 << (next % 64);
+            queue[tail++] = next;
+        }
+    }
+
+    //the queue holds one generation after another, so a generation ends where the queue ended when it started
+    int generation = 1;
+    while(head < tail){
+        int end = tail;
+        for(; head < end; head++){
+            int current = queue[head];
+            visit(graph->individuals[current], generation, state);
+
+            if(maxGen != 0 && generation >= maxGen){
+                continue;
+            }
+
+            for(int e = start[current]; e < start[current + 1]; e++){
+                int next = edges[e];
+                if(!(visited[next / 64] & ((uint64_t)1 << (next % 64)))){
+                    visited[next / 64] |= (uint64_t)1 << (next % 64);
+                    queue[tail++] = next;
+                }
+            }
+        }
+        generation++;
+    }
+
+    free(visited);
+    free(queue);
+}
+
+/** Function to check whether the walk that labelled the graph reached b below a
+*@return true if it did, which makes a an ancestor of b
+*@param index - pointer to the index
+*@param a - id of the possible ancestor
+*@param b - id of the possible descendant
+**/
+static bool reachedBelow(const AncestorIndex* index, int a, int b){
+    return index->pre[a] < index->pre[b] && index->post[b] < index->post[a];
+}
+
+/** Function to check whether the labels of a leave room for b to be its descendant
+*@return false if b cannot be a descendant of a
+*@param index - pointer to the index
+*@param a - id of the possible ancestor
+*@param b - id of the possible descendant
+**/
+static bool mayReach(const AncestorIndex* index, int a, int b){
+    return index->low[a] <= index->post[b] && index->post[b] < index->post[a];
+}
+
+AncestorIndex* createAncestorIndex(const GEDCOMobject* obj){
+    if(obj == NULL){
+        return NULL;
+    }
+
+    AncestorIndex* index = calloc(1, sizeof(AncestorIndex));
+    if(index == NULL){
+        return NULL;
+    }
+
+    //an object loaded with LOAD_GRAPH already has a graph, otherwise the index needs its own
+    index->graph = getFamilyGraph(obj);
+    if(index->graph == NULL){
+        index->ownGraph = createFamilyGraph(obj);
+        index->graph = index->ownGraph;
+    }
+    if(index->graph == NULL){
+        deleteAncestorIndex(index);
+        return NULL;
+    }
+
+    const FamilyGraph* graph = index->graph;
+    int count = graph->individualCount;
+    index->pre = malloc(sizeof(int) * (count + 1));
+    index->post = malloc(sizeof(int) * (count + 1));
+    index->low = malloc(sizeof(int) * (count + 1));
+    int* stack = malloc(sizeof(int) * (count + 1));
+    int* cursor = malloc(sizeof(int) * (count + 1));
+    if(index->pre == NULL || index->post == NULL || index->low == NULL || stack == NULL || cursor == NULL){
+        free(stack);
+        free(cursor);
+        deleteAncestorIndex(index);
+        return NULL;
+    }
+
+    for(int i = 0; i < count; i++){
+        index->pre[i] = -1;
+        index->post[i] = -1;
+        index->low[i] = INT_MAX;
+    }
+
+    //walk down from the individuals without parents first, the rest only matters for broken links
+    int preCount = 0;
+    int postCount = 0;
+    for(int pass = 0; pass < 2; pass++){
+        for(int root = 0; root < count; root++){
+            bool hasParents = graph->parentStart[root] != graph->parentStart[root + 1];
+            if(index->pre[root] >= 0 || (pass == 0 && hasParents)){
+                continue;
+            }
+
+            int top = 0;
+            stack[top++] = root;
+            index->pre[root] = preCount++;
+            cursor[root] = graph->childStart[root];
+
+            while(top > 0){
+                int current = stack[top - 1];
+
+                if(cursor[current] < graph->childStart[current + 1]){
+                    int child = graph->childIds[cursor[current]++];
+                    if(index->pre[child] < 0){
+                        index->pre[child] = preCount++;
+                        cursor[child] = graph->childStart[child];
+                        stack[top++] = child;
+                    }
+                    else if(index->post[child] >= 0 && index->low[child] < index->low[current]){
+                        index->low[current] = index->low[child];
+                    }
+                    continue;
+                }
+
+                //everything below current is done
+                top--;
+                index->post[current] = postCount++;
+                if(index->post[current] < index->low[current]){
+                    index->low[current] = index->post[current];
+                }
+                if(top > 0 && index->low[current] < index->low[stack[top - 1]]){
+                    index->low[stack[top - 1]] = index->low[current];
+                }
+            }
+        }
+    }
+
+    free(stack);
+    free(cursor);
+
+    return index;
+}
+
+void deleteAncestorIndex(AncestorIndex* index){
+    if(index == NULL){
+        return;
+    }
+
+    deleteFamilyGraph(index->ownGraph);
+    free(index->pre);
+    free(index->post);
+    free(index->low);
+    free(index);
+}
+
+bool isAncestor(const AncestorIndex* index, const Individual* ancestor, const Individual* person){
+    if(index == NULL || ancestor == NULL || person == NULL){
+        return false;
+    }
+
+    int a = getIndividualId(index->graph, ancestor);
+    int b = getIndividualId(index->graph, person);
+    if(a < 0 || b < 0 || a == b){
+        return false;
+    }
+
+    if(reachedBelow(index, a, b)){
+        return true;
+    }
+    if(!mayReach(index, a, b)){
+        return false;
+    }
+
+    //search down from a, only through individuals whose labels still leave room for b
+    const FamilyGraph* graph = index->graph;
+    uint64_t* visited = calloc(graph->individualCount / 64 + 1, sizeof(uint64_t));
+    int* stack = malloc(sizeof(int) * graph->individualCount);
+    if(visited == NULL || stack == NULL){
+        free(visited);
+        free(stack);
+        return false;
+    }
+
+    bool found = false;
+    int top = 0;
+    stack[top++] = a;
+    visited[a / 64] |= (uint64_t)1 << (a % 64);
+    while(top > 0 && !found){
+        int current = stack[--top];
+        for(int e = graph->childStart[current]; e < graph->childStart[current + 1]; e++){
+            int child = graph->childIds[e];
+            if(child == b || reachedBelow(index, child, b)){
+                found = true;
+                break;
+            }
+            if(!(visited[child / 64] & ((uint64_t)1 << (child % 64))) && mayReach(index, child, b)){
+                visited[child / 64] |= (uint64_t)1 << (child % 64);
+                stack[top++] = child;
+            }
+        }
+    }
+
+    free(visited);
+    free(stack);
+
+    return found;
+}
+
+bool isCommonAncestor(const AncestorIndex* index, const Individual* ancestor, const Individual* first, const Individual* second){
+    if(index == NULL || ancestor == NULL || first == NULL || second == NULL){
+        return false;
+    }
+
+    return (ancestor == first || isAncestor(index, ancestor, first)) &&
+        (ancestor == second || isAncestor(index, ancestor, second));
+}
+
+/** Function to mark an individual and all its ancestors over the parent edges
+*@param graph - pointer to the graph
+*@param id - id of the individual
+*@param marked - bitmap over the ids, the ancestors are set in it
+*@param queue - room for every id of the graph
+**/
+static void markAncestors(const FamilyGraph* graph, int id, uint64_t* marked, int* queue){
+    int head = 0;
+    int tail = 0;
+    queue[tail++] = id;
+    marked[id / 64] |= (uint64_t)1 << (id % 64);
+
+    while(head < tail){
+        int current = queue[head++];
+        for(int e = graph->parentStart[current]; e < graph->parentStart[current + 1]; e++){
+            int parent = graph->parentIds[e];
+            if(!(marked[parent / 64] & ((uint64_t)1 << (parent % 64)))){
+                marked[parent / 64] |= (uint64_t)1 << (parent % 64);
+                queue[tail++] = parent;
+            }
+        }
+    }
+}
+
+bool haveCommonAncestor(const AncestorIndex* index, const Individual* first, const Individual* second){
+    if(index == NULL || first == NULL || second == NULL){
+        return false;
+    }
+
+    int a = getIndividualId(index->graph, first);
+    int b = getIndividualId(index->graph, second);
+    if(a < 0 || b < 0){
+        return false;
+    }
+    if(a == b || isAncestor(index, first, second) || isAncestor(index, second, first)){
+        return true;
+    }
+
+    const FamilyGraph* graph = index->graph;
+    int words = graph->individualCount / 64 + 1;
+    uint64_t* marked = calloc(words * 2, sizeof(uint64_t));
+    int* queue = malloc(sizeof(int) * graph->individualCount);
+    if(marked == NULL || queue == NULL){
+        free(marked);
+        free(queue);
+        return false;
+    }
+
+    //the second half of marked is the visited set of the walk up from the second person
+    markAncestors(graph, a, marked, queue);
+    uint64_t* visited = marked + words;
+
+    bool found = false;
+    int head = 0;
+    int tail = 0;
+    queue[tail++] = b;
+    visited[b / 64] |= (uint64_t)1 << (b % 64);
+    while(head < tail && !found){
+        int current = queue[head++];
+        if(marked[current / 64] & ((uint64_t)1 << (current % 64))){
+            found = true;
+            break;
+        }
+        for(int e = graph->parentStart[current]; e < graph->parentStart[current + 1]; e++){
+            int parent = graph->parentIds[e];
+            if(!(visited[parent / 64] & ((uint64_t)1 << (parent % 64)))){
+                visited[parent / 64] |= (uint64_t)1 << (parent % 64);
+                queue[tail++] = parent;
+            }
+        }
+    }
+
+    free(marked);
+    free(queue);
+
+    return found;
+}
@@ -0,0 +1,669 @@
+#define _DEFAULT_SOURCE
+
+#include "GEDCOMkinship.h"
+#include "GEDCOMutilities.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+
+//pairs a memo keeps from one question to the next, more than that and it is emptied before the next one
+#ifndef KINSHIP_MEMO_LIMIT
+#define KINSHIP_MEMO_LIMIT (1 << 22)
+#endif
+
+//parts of the memo computeKinships shares between its threads, each behind its own lock
+#define KINSHIP_MEMO_SHARDS 64
+
+//kinship of a pair of ids, the smaller id first, the key of the memo points at it
+typedef struct{
+    int first;
+    int second;
+    double value;
+} kinshipPair;
+
+//one part of a shared memo
+typedef struct{
+    KinshipMemo memo;
+    pthread_mutex_t lock;
+} memoShard;
+
+//memo shared by the threads of computeKinships, so pairs one thread works out are not worked out again by the others
+typedef struct{
+    memoShard shards[KINSHIP_MEMO_SHARDS];
+    //pairs in all of the shards
+    atomic_int pairs;
+
+    //questions being worked out, the memo is only emptied while there are none
+    pthread_mutex_t lock;
+    pthread_cond_t idle;
+    int running;
+    bool emptying;
+} sharedMemo;
+
+//the memo a question uses, either the engine's own, which only one thread uses, or a shared one
+typedef struct{
+    KinshipMemo* own;
+    sharedMemo* shared;
+} memoRef;
+
+//work of one thread of computeKinships
+typedef struct{
+    const KinshipEngine* engine;
+    sharedMemo* memo;
+    const Individual** first;
+    const Individual** second;
+    int start;
+    int end;
+    kinshipMeasure measure;
+    double* results;
+    //false when the block ran on the calling thread instead
+    bool threaded;
+} kinshipWork;
+
+/** Function to hash a pair of ids
+*@return the hash
+*@param key - pointer to a kinshipPair
+**/
+static unsigned long hashPair(const void* key){
+    const kinshipPair* pair = (const kinshipPair*)key;
+    unsigned long hash = (unsigned long)(unsigned int)pair->first * 2654435761UL;
+
+    return hash ^ ((unsigned long)(unsigned int)pair->second * 40503UL + (hash >> 16));
+}
+
+/** Function to compare two pairs of ids
+*@return true if they are the same pair
+*@param first - pointer to a kinshipPair
+*@param second - pointer to a kinshipPair
+**/
+static bool comparePairs(const void* first, const void* second){
+    const kinshipPair* a = (const kinshipPair*)first;
+    const kinshipPair* b = (const kinshipPair*)second;
+
+    return a->first == b->first && a->second == b->second;
+}
+
+/** Function to start an empty memo
+*@return the memo
+**/
+static KinshipMemo initializeMemo(void){
+    KinshipMemo memo;
+
+    //the pairs are freed with the arena, not by the table
+    memo.pairs = initializeTable(0, &hashPair, &comparePairs, &dummyDelete);
+    memo.arena = initializeArena();
+
+    return memo;
+}
+
+/** Function to free a memo
+*@param memo - pointer to the memo
+**/
+static void clearMemo(KinshipMemo* memo){
+    clearTable(&memo->pairs);
+    clearArena(&memo->arena);
+}
+
+/** Function to look up a pair in a memo
+*@return pointer to the kinship, NULL if it has not been worked out
+*@param memo - pointer to the memo
+*@param a - id of one individual
+*@param b - id of the other
+**/
+static double* findPair(KinshipMemo* memo, int a, int b){
+    kinshipPair key;
+    key.first = a < b ? a : b;
+    key.second = a < b ? b : a;
+
+    kinshipPair* pair = (kinshipPair*)lookupTable(memo->pairs, &key);
+
+    return pair == NULL ? NULL : &pair->value;
+}
+
+/** Function to add a pair to a memo
+*@return false if memory ran out
+*@param memo - pointer to the memo
+*@param a - id of one individual
+*@param b - id of the other
+*@param value - their kinship
+**/
+static bool storePair(KinshipMemo* memo, int a, int b, double value){
+    kinshipPair* pair = arenaAlloc(&memo->arena, sizeof(kinshipPair));
+    if(pair == NULL){
+        return false;
+    }
+
+    pair->first = a < b ? a : b;
+    pair->second = a < b ? b : a;
+    pair->value = value;
+
+    return insertTable(&memo->pairs, pair, pair);
+}
+
+/** Function to pick the shard of a shared memo a pair is kept in
+*@return the shard
+*@param shared - pointer to the shared memo
+*@param a - id of one individual
+*@param b - id of the other
+**/
+static memoShard* pairShard(sharedMemo* shared, int a, int b){
+    unsigned int key = (unsigned int)(a < b ? a : b) * 31u + (unsigned int)(a < b ? b : a);
+
+    return &shared->shards[key % KINSHIP_MEMO_SHARDS];
+}
+
+/** Function to look up a pair in the memo of a question
+*@return true if it has been worked out
+*@param memo - the memo
+*@param a - id of one individual
+*@param b - id of the other
+*@param value - set to their kinship if it has been worked out, left alone otherwise
+**/
+static bool memoFind(const memoRef* memo, int a, int b, double* value){
+    if(memo->shared == NULL){
+        double* known = findPair(memo->own, a, b);
+        if(known != NULL){
+            *value = *known;
+        }
+        return known != NULL;
+    }
+
+    //the value is copied while the shard is locked, the table may grow once it is let go
+    memoShard* shard = pairShard(memo->shared, a, b);
+    pthread_mutex_lock(&shard->lock);
+    double* known = findPair(&shard->memo, a, b);
+    if(known != NULL){
+        *value = *known;
+    }
+    pthread_mutex_unlock(&shard->lock);
+
+    return known != NULL;
+}
+
+/** Function to add a pair to the memo of a question
+*@return false if memory ran out
+*@param memo - the memo
+*@param a - id of one individual
+*@param b - id of the other
+*@param value - their kinship
+**/
+static bool memoStore(const memoRef* memo, int a, int b, double value){
+    if(memo->shared == NULL){
+        return storePair(memo->own, a, b, value);
+    }
+
+    //another thread may have stored the pair first, with the same value
+    memoShard* shard = pairShard(memo->shared, a, b);
+    bool stored = true;
+    pthread_mutex_lock(&shard->lock);
+    if(findPair(&shard->memo, a, b) == NULL){
+        stored = storePair(&shard->memo, a, b, value);
+        if(stored){
+            atomic_fetch_add(&memo->shared->pairs, 1);
+        }
+    }
+    pthread_mutex_unlock(&shard->lock);
+
+    return stored;
+}
+
+/** Function to start a question, emptying the memo first if it has grown past KINSHIP_MEMO_LIMIT.
+* A question keeps every pair it adds, so a shared memo waits for the questions of the other threads to end before it is emptied.
+*@param memo - the memo
+**/
+static void beginQuestion(const memoRef* memo){
+    if(memo->shared == NULL){
+        if(getTableLength(memo->own->pairs) > KINSHIP_MEMO_LIMIT){
+            clearMemo(memo->own);
+            *memo->own = initializeMemo();
+        }
+        return;
+    }
+
+    sharedMemo* shared = memo->shared;
+    pthread_mutex_lock(&shared->lock);
+    while(shared->emptying){
+        pthread_cond_wait(&shared->idle, &shared->lock);
+    }
+    if(atomic_load(&shared->pairs) > KINSHIP_MEMO_LIMIT){
+        shared->emptying = true;
+        while(shared->running > 0){
+            pthread_cond_wait(&shared->idle, &shared->lock);
+        }
+        for(int i = 0; i < KINSHIP_MEMO_SHARDS; i++){
+            clearMemo(&shared->shards[i].memo);
+            shared->shards[i].memo = initializeMemo();
+        }
+        atomic_store(&shared->pairs, 0);
+        shared->emptying = false;
+        pthread_cond_broadcast(&shared->idle);
+    }
+    shared->running++;
+    pthread_mutex_unlock(&shared->lock);
+}
+
+/** Function to end a question started with beginQuestion
+*@param memo - the memo
+**/
+static void endQuestion(const memoRef* memo){
+    if(memo->shared == NULL){
+        return;
+    }
+
+    sharedMemo* shared = memo->shared;
+    pthread_mutex_lock(&shared->lock);
+    shared->running--;
+    if(shared->running == 0){
+        pthread_cond_broadcast(&shared->idle);
+    }
+    pthread_mutex_unlock(&shared->lock);
+}
+
+/** Function to work out the kinship of two ids without recursion.
+* A pair waits on a stack until the pairs it is made from are in the memo, its later individual is
+* replaced by that individual's parents, which always come earlier in the order.
+* The pairs are kept until the question is answered, so a question about a deep, interwoven pedigree
+* can take the memo well past KINSHIP_MEMO_LIMIT, millions of pairs for two people with thousands of ancestors each.
+*@return the kinship, 0 if either id is -1 or memory ran out
+*@param engine - pointer to the engine
+*@param memo - the memo to use and add to
+*@param a - id of one individual
+*@param b - id of the other
+**/
+static double kinshipOf(const KinshipEngine* engine, const memoRef* memo, int a, int b){
+    if(a < 0 || b < 0){
+        return 0;
+    }
+
+    beginQuestion(memo);
+
+    double value = 0;
+    if(memoFind(memo, a, b, &value)){
+        endQuestion(memo);
+        return value;
+    }
+
+    int size = 64;
+    int top = 0;
+    int* stack = malloc(sizeof(int) * size);
+    if(stack == NULL){
+        endQuestion(memo);
+        return 0;
+    }
+    stack[top++] = a;
+    stack[top++] = b;
+
+    bool failed = false;
+    while(top > 0){
+        int x = stack[top - 2];
+        int y = stack[top - 1];
+        //x is the one that comes later, so it cannot be an ancestor of y
+        if(engine->order[x] < engine->order[y]){
+            int swap = x;
+            x = y;
+            y = swap;
+        }
+
+        if(memoFind(memo, x, y, &value)){
+            top -= 2;
+            continue;
+        }
+
+        int father = engine->father[x];
+        int mother = engine->mother[x];
+        int need[4];
+        int needed = 0;
+
+        if(x == y){
+            double parents = 0;
+            if(father >= 0 && mother >= 0 && !memoFind(memo, father, mother, &parents)){
+                need[needed++] = father;
+                need[needed++] = mother;
+            }
+            value = 0.5 * (1 + parents);
+        }
+        else{
+            double fromFather = 0;
+            double fromMother = 0;
+            if(father >= 0 && !memoFind(memo, father, y, &fromFather)){
+                need[needed++] = father;
+                need[needed++] = y;
+            }
+            if(mother >= 0 && !memoFind(memo, mother, y, &fromMother)){
+                need[needed++] = mother;
+                need[needed++] = y;
+            }
+            value = 0.5 * (fromFather + fromMother);
+        }
+
+        if(needed > 0){
+            if(top + needed > size){
+                size *= 2;
+                int* grown = realloc(stack, sizeof(int) * size);
+                if(grown == NULL){
+                    failed = true;
+                    break;
+                }
+                stack = grown;
+            }
+            for(int i = 0; i < needed; i++){
+                stack[top++] = need[i];
+            }
+            continue;
+        }
+
+        if(!memoStore(memo, x, y, value)){
+            failed = true;
+            break;
+        }
+        top -= 2;
+    }
+
+    free(stack);
+
+    value = 0;
+    if(!failed){
+        memoFind(memo, a, b, &value);
+    }
+    endQuestion(memo);
+
+    return value;
+}
+
+/** Function to work out the measure asked for, for one pair of records
+*@return the coefficient
+*@param engine - pointer to the engine
+*@param memo - the memo to use and add to
+*@param first - the first individual
+*@param second - the second individual
+*@param measure - the coefficient to work out
+**/
+static double measurePair(const KinshipEngine* engine, const memoRef* memo, const Individual* first, const Individual* second, kinshipMeasure measure){
+    if(first == NULL || second == NULL){
+        return 0;
+    }
+
+    int a = getIndividualId(engine->graph, first);
+    int b = getIndividualId(engine->graph, second);
+    double kinship = kinshipOf(engine, memo, a, b);
+
+    if(measure == KINSHIP_COEFFICIENT || kinship == 0){
+        return kinship;
+    }
+
+    double inbreedingA = kinshipOf(engine, memo, engine->father[a], engine->mother[a]);
+    double inbreedingB = kinshipOf(engine, memo, engine->father[b], engine->mother[b]);
+
+    return 2 * kinship / sqrt((1 + inbreedingA) * (1 + inbreedingB));
+}
+
+KinshipEngine* createKinshipEngine(const GEDCOMobject* obj){
+    if(obj == NULL){
+        return NULL;
+    }
+
+    KinshipEngine* engine = calloc(1, sizeof(KinshipEngine));
+    if(engine == NULL){
+        return NULL;
+    }
+    engine->memo = initializeMemo();
+
+    //an object loaded with LOAD_GRAPH already has a graph, otherwise the engine needs its own
+    engine->graph = getFamilyGraph(obj);
+    if(engine->graph == NULL){
+        engine->ownGraph = createFamilyGraph(obj);
+        engine->graph = engine->ownGraph;
+    }
+    if(engine->graph == NULL){
+        deleteKinshipEngine(engine);
+        return NULL;
+    }
+
+    const FamilyGraph* graph = engine->graph;
+    int count = graph->individualCount;
+    engine->father = malloc(sizeof(int) * (count + 1));
+    engine->mother = malloc(sizeof(int) * (count + 1));
+    engine->order = malloc(sizeof(int) * (count + 1));
+    int* waiting = calloc(count + 1, sizeof(int));
+    int* childStart = calloc(count + 2, sizeof(int));
+    int* children = malloc(sizeof(int) * (2 * count + 1));
+    int* queue = malloc(sizeof(int) * (count + 1));
+    if(engine->father == NULL || engine->mother == NULL || engine->order == NULL ||
+        waiting == NULL || childStart == NULL || children == NULL || queue == NULL){
+        free(waiting);
+        free(childStart);
+        free(children);
+        free(queue);
+        deleteKinshipEngine(engine);
+        return NULL;
+    }
+
+    for(int i = 0; i < count; i++){
+        Individual* individual = graph->individuals[i];
+        engine->father[i] = -1;
+        engine->mother[i] = -1;
+        engine->order[i] = count;
+
+        ListIterator iter = createIterator(individual->families);
+        while(iter.current != NULL){
+            Family* family = (Family*)iter.current->data;
+            if(family->husband != individual && family->wife != individual){
+                engine->father[i] = family->husband == NULL ? -1 : getIndividualId(graph, family->husband);
+                engine->mother[i] = family->wife == NULL ? -1 : getIndividualId(graph, family->wife);
+                break;
+            }
+            nextElement(&iter);
+        }
+
+        //each known parent has to be ordered before the child can be
+        if(engine->father[i] >= 0){
+            waiting[i]++;
+            childStart[engine->father[i] + 1]++;
+        }
+        if(engine->mother[i] >= 0 && engine->mother[i] != engine->father[i]){
+            waiting[i]++;
+            childStart[engine->mother[i] + 1]++;
+        }
+    }
+
+    //children of each parent, in the compressed form the family graph uses
+    for(int i = 0; i < count; i++){
+        childStart[i + 1] += childStart[i];
+    }
+    int* fill = queue;
+    memcpy(fill, childStart, sizeof(int) * count);
+    for(int i = 0; i < count; i++){
+        if(engine->father[i] >= 0){
+            children[fill[engine->father[i]]++] = i;
+        }
+        if(engine->mother[i] >= 0 && engine->mother[i] != engine->father[i]){
+            children[fill[engine->mother[i]]++] = i;
+        }
+    }
+
+    //individuals are ordered once all their parents are
+    int head = 0;
+    int tail = 0;
+    for(int i = 0; i < count; i++){
+        if(waiting[i] == 0){
+            queue[tail++] = i;
+        }
+    }
+    while(head < tail){
+        int current = queue[head];
+        engine->order[current] = head++;
+        for(int e = childStart[current]; e < childStart[current + 1]; e++){
+            if(--waiting[children[e]] == 0){
+                queue[tail++] = children[e];
+            }
+        }
+    }
+
+    //individuals in a loop of broken links are never ordered, the parent links that do not go back in order are dropped
+    for(int i = 0; i < count; i++){
+        if(engine->father[i] >= 0 && engine->order[engine->father[i]] >= engine->order[i]){
+            engine->father[i] = -1;
+        }
+        if(engine->mother[i] >= 0 && engine->order[engine->mother[i]] >= engine->order[i]){
+            engine->mother[i] = -1;
+        }
+    }
+
+    free(waiting);
+    free(childStart);
+    free(children);
+    free(queue);
+
+    return engine;
+}
+
+void deleteKinshipEngine(KinshipEngine* engine){
+    if(engine == NULL){
+        return;
+    }
+
+    clearMemo(&engine->memo);
+    deleteFamilyGraph(engine->ownGraph);
+    free(engine->father);
+    free(engine->mother);
+    free(engine->order);
+    free(engine);
+}
+
+double getKinship(KinshipEngine* engine, const Individual* first, const Individual* second){
+    if(engine == NULL){
+        return 0;
+    }
+
+    memoRef memo = {&engine->memo, NULL};
+
+    return measurePair(engine, &memo, first, second, KINSHIP_COEFFICIENT);
+}
+
+double getInbreeding(KinshipEngine* engine, const Individual* individual){
+    if(engine == NULL || individual == NULL){
+        return 0;
+    }
+
+    int id = getIndividualId(engine->graph, individual);
+    if(id < 0){
+        return 0;
+    }
+
+    memoRef memo = {&engine->memo, NULL};
+
+    return kinshipOf(engine, &memo, engine->father[id], engine->mother[id]);
+}
+
+double getRelationshipCoefficient(KinshipEngine* engine, const Individual* first, const Individual* second){
+    if(engine == NULL){
+        return 0;
+    }
+
+    memoRef memo = {&engine->memo, NULL};
+
+    return measurePair(engine, &memo, first, second, RELATIONSHIP_COEFFICIENT);
+}
+
+/** Function run by each thread of computeKinships
+*@return NULL
+*@param data - pointer to the kinshipWork of the thread
+**/
+static void* kinshipWorker(void* data){
+    kinshipWork* work = (kinshipWork*)data;
+
+    //a single thread has a memo of its own, which needs no locks
+    KinshipMemo own;
+    memoRef memo = {NULL, work->memo};
+    if(work->memo == NULL){
+        own = initializeMemo();
+        memo.own = &own;
+    }
+
+    for(int i = work->start; i < work->end; i++){
+        work->results[i] = measurePair(work->engine, &memo, work->first[i], work->second[i], work->measure);
+    }
+
+    if(work->memo == NULL){
+        clearMemo(&own);
+    }
+
+    return NULL;
+}
+
+bool computeKinships(const KinshipEngine* engine, const Individual** first, const Individual** second, int count, kinshipMeasure measure, double* results, int threads){
+    if(engine == NULL || first == NULL || second == NULL || results == NULL || count < 0){
+        return false;
+    }
+
+    if(threads <= 0){
+        long processors = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = processors > 0 ? (int)processors : 1;
+    }
+    if(threads > count){
+        threads = count > 0 ? count : 1;
+    }
+
+    kinshipWork* work = malloc(sizeof(kinshipWork) * threads);
+    pthread_t* ids = malloc(sizeof(pthread_t) * threads);
+    sharedMemo* memo = malloc(sizeof(sharedMemo));
+    if(work == NULL || ids == NULL || memo == NULL){
+        free(work);
+        free(ids);
+        free(memo);
+        return false;
+    }
+
+    for(int i = 0; i < KINSHIP_MEMO_SHARDS; i++){
+        memo->shards[i].memo = initializeMemo();
+        pthread_mutex_init(&memo->shards[i].lock, NULL);
+    }
+    atomic_init(&memo->pairs, 0);
+    pthread_mutex_init(&memo->lock, NULL);
+    pthread_cond_init(&memo->idle, NULL);
+    memo->running = 0;
+    memo->emptying = false;
+
+    for(int t = 0; t < threads; t++){
+        work[t].engine = engine;
+        work[t].memo = threads > 1 ? memo : NULL;
+        work[t].first = first;
+        work[t].second = second;
+        work[t].start = (int)((long)count * t / threads);
+        work[t].end = (int)((long)count * (t + 1) / threads);
+        work[t].measure = measure;
+        work[t].results = results;
+        work[t].threaded = false;
+
+        //the last block runs on the calling thread, as does any block a thread could not be started for
+        if(t < threads - 1 && pthread_create(&ids[t], NULL, &kinshipWorker, &work[t]) == 0){
+            work[t].threaded = true;
+        }
+        else{
+            kinshipWorker(&work[t]);
+        }
+    }
+
+    for(int t = 0; t < threads; t++){
+        if(work[t].threaded){
+            pthread_join(ids[t], NULL);
+        }
+    }
+
+    for(int i = 0; i < KINSHIP_MEMO_SHARDS; i++){
+        clearMemo(&memo->shards[i].memo);
+        pthread_mutex_destroy(&memo->shards[i].lock);
+    }
+    pthread_mutex_destroy(&memo->lock);
+    pthread_cond_destroy(&memo->idle);
+    free(memo);
+    free(work);
+    free(ids);
+
+    return true;
+}
@@ -0,0 +1,531 @@
+#define _DEFAULT_SOURCE
+
+#include "GEDCOMutilities.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+
+//parts smaller than this are not worth a thread of their own
+#ifndef PARALLEL_MIN_PART
+#define PARALLEL_MIN_PART (1024 * 1024)
+#endif
+
+//threads to parse with, 0 for one per processor
+#ifndef PARALLEL_THREADS
+#define PARALLEL_THREADS 0
+#endif
+
+//records of writeGEDCOM to a part before the part is worth a thread of its own
+#ifndef PARALLEL_WRITE_RECORDS
+#define PARALLEL_WRITE_RECORDS 4096
+#endif
+
+//a part of the file after the header and what parsing it left
+typedef struct{
+    const char* data;
+    size_t size;
+    //the end of the last part is the end of the file
+    bool last;
+
+    parseState state;
+    GEDCOMerror error;
+    bool trailer;
+    //lines read, to turn line numbers of the part into line numbers of the file
+    int lines;
+    //the records have been moved into the object being loaded
+    bool merged;
+} filePart;
+
+//parts of the records shared by the threads of writeRecordsParallel
+typedef struct{
+    const writeRecords* records;
+    int count;
+    int parts;
+    //what each part was formatted into, NULL if there was no memory for it
+    GEDCOMwriter** formatted;
+    //index of the next part nobody has taken
+    atomic_int next;
+} writePool;
+
+/** Function to check if a line starts a record that can begin a part of the file
+ * Only lines like "0 @xref@ TAG" are used, and never a CONT or CONC line, which would be joined onto the line before it.
+ *@return true if the file can be split in front of the line
+ *@param line - start of the line
+ *@param length - characters left in the file from the start of the line
+ **/
+static bool startsRecord(const char* line, size_t length){
+    if(length < 3 || line[0] != '0' || line[1] != ' ' || line[2] != '@'){
+        return false;
+    }
+
+    size_t cur = 3;
+    while(cur < length && line[cur] != ' ' && line[cur] != '\n' && line[cur] != '\r'){
+        cur++;
+    }
+    while(cur < length && line[cur] == ' '){
+        cur++;
+    }
+
+    if(length - cur >= 4 && (memcmp(line + cur, "CONT", 4) == 0 || memcmp(line + cur, "CONC", 4) == 0)){
+        return length - cur > 4 && line[cur + 4] != ' ' && line[cur + 4] != '\n' && line[cur + 4] != '\r';
+    }
+
+    return true;
+}
+
+/** Function to find the first line at or after an offset where the file can be split
+ *@return offset of the line, size if there is none
+ *@param data - the whole file
+ *@param from - offset to start looking at
+ *@param size - size of the file
+ **/
+static size_t nextSplit(const char* data, size_t from, size_t size){
+    for(size_t cur = from > 0 ? from : 1; cur < size; cur++){
+        if((data[cur - 1] == '\n' || data[cur - 1] == '\r') && startsRecord(data + cur, size - cur)){
+            return cur;
+        }
+    }
+
+    return size;
+}
+
+/** Function to move the nodes of one list onto the end of another
+ *@param to - the list that takes the nodes
+ *@param from - the list that gives them up, left empty
+ **/
+static void appendNodes(List* to, List* from){
+    if(from->head == NULL){
+        return;
+    }
+
+    if(to->tail == NULL){
+        to->head = from->head;
+    }
+    else{
+        to->tail->next = from->head;
+        from->head->previous = to->tail;
+    }
+    to->tail = from->tail;
+    to->length += from->length;
+
+    from->head = NULL;
+    from->tail = NULL;
+    from->length = 0;
+}
+
+/** Function run by each thread, parses one part of the file into its own state
+ *@return NULL
+ *@param data - pointer to the filePart
+ **/
+static void* parsePart(void* data){
+    filePart* part = (filePart*)data;
+
+    GEDCOMhandler handler;
+    handler.startRecord = &loadStartRecord;
+    handler.recordLine = &loadRecordLine;
+    handler.endRecord = &loadEndRecord;
+    handler.state = &part->state;
+
+    part->error.type = OK;
+    part->error.line = -1;
+    part->trailer = false;
+
+    GEDCOMreader* reader = createMemoryReader(part->data, part->size);
+    if(reader == NULL){
+        part->error.type = OTHER_ERROR;
+        return NULL;
+    }
+
+    streamRecords(reader, &handler, NO_RECORD, part->last, &part->trailer, &part->error);
+    part->lines = reader->lineNumb;
+    deleteReader(reader);
+
+    return NULL;
+}
+
+/** Function to find the copy of an interned string in the string pool of the object being loaded
+ *@return the pooled copy, str itself if the pool does not have it
+ *@param pool - string pool of the object being loaded
+ *@param str - a string a part interned
+ **/
+static char* pooledString(HashTable pool, char* str){
+    GEDCOMspan span;
+    span.start = str;
+    span.length = strlen(str);
+
+    GEDCOMspan* found = lookupTable(pool, &span);
+
+    return found == NULL ? str : (char*)found->start;
+}
+
+/** Function to point the tags of a list of fields at the pooled copies
+ *@param pool - string pool of the object being loaded
+ *@param fields - list of Field*
+ **/
+static void poolFields(HashTable pool, List* fields){
+    ListIterator iter = createIterator(*fields);
+    Field* field;
+    while((field = nextElement(&iter)) != NULL){
+        field->tag = pooledString(pool, field->tag);
+    }
+}
+
+/** Function to point the places and field tags of a list of events at the pooled copies
+ *@param pool - string pool of the object being loaded
+ *@param events - list of Event*
+ **/
+static void poolEvents(HashTable pool, List* events){
+    ListIterator iter = createIterator(*events);
+    Event* event;
+    while((event = nextElement(&iter)) != NULL){
+        event->place = pooledString(pool, event->place);
+        poolFields(pool, &event->otherFields);
+    }
+}
+
+/** Function to add the string pool of a part to the pool of the object being loaded, as if one pool had seen every string in file order
+ * Strings the object already has are dropped from the part, and its records are pointed at the copies the object keeps.
+ *@param state - loader state of the object
+ *@param from - loader state of the part
+ **/
+static void mergePool(parseState* state, parseState* from){
+    GEDCOMstats* stats = &state->pool->stats;
+    GEDCOMstats* part = &from->pool->stats;
+
+    //every string interned is either the first of its kind or a repeat, so their bytes add up to the same whichever part saw it
+    size_t interned = stats->stringBytes + stats->savedBytes + part->stringBytes + part->savedBytes;
+    stats->strings += part->strings;
+
+    HashTable* pool = &state->pool->strings;
+    HashTable* strings = &from->pool->strings;
+    bool repeats = false;
+    for(int i = 0; i < strings->size; i++){
+        GEDCOMspan* key = (GEDCOMspan*)strings->entries[i].key;
+        if(key == NULL){
+            continue;
+        }
+        if(lookupTable(*pool, key) != NULL){
+            repeats = true;
+        }
+        else{
+            insertTable(pool, key, key);
+            stats->uniqueStrings++;
+            stats->stringBytes += key->length + 1;
+        }
+    }
+    stats->savedBytes = interned - stats->stringBytes;
+
+    //the part's own copy of a string the object already had is left unused in the arena
+    if(!repeats){
+        return;
+    }
+
+    ListIterator iter = createIterator(from->obj->individuals);
+    Individual* indi;
+    while((indi = nextElement(&iter)) != NULL){
+        indi->surname = pooledString(*pool, indi->surname);
+        poolFields(*pool, &indi->otherFields);
+        poolEvents(*pool, &indi->events);
+    }
+
+    iter = createIterator(from->obj->families);
+    Family* fam;
+    while((fam = nextElement(&iter)) != NULL){
+        poolFields(*pool, &fam->otherFields);
+        poolEvents(*pool, &fam->events);
+    }
+
+    if(from->obj->submitter != NULL){
+        poolFields(*pool, &from->obj->submitter->otherFields);
+    }
+}
+
+/** Function to move what a part parsed into the object being loaded, after the parts before it
+ *@param state - loader state of the object
+ *@param part - the part, parsed without an error
+ *@param offset - number of lines in the file before the part
+ **/
+static void mergePart(parseState* state, filePart* part, int offset){
+    parseState* from = &part->state;
+
+    //strings are pooled while the records are still the part's own
+    if(from->pool->strings.entries != NULL){
+        mergePool(state, from);
+    }
+
+    appendNodes(&state->obj->individuals, &from->obj->individuals);
+    appendNodes(&state->obj->families, &from->obj->families);
+
+    //the first submitter in the file is the one that is kept
+    if(state->obj->submitter == NULL){
+        state->obj->submitter = from->obj->submitter;
+    }
+
+    //references resolve to the first individual with a tag, so a tag already seen in an earlier part wins
+    for(int i = 0; i < from->xrefTable.size; i++){
+        TableEntry* entry = &from->xrefTable.entries[i];
+        if(entry->key != NULL && !insertTable(&state->xrefTable, entry->key, entry->data)){
+            from->xrefTable.deleteData(entry->data);
+        }
+    }
+    from->xrefTable.deleteData = &dummyDelete;
+
+    ListIterator iter = createIterator(from->pendingRefs);
+    pendingRef* ref;
+    while((ref = nextElement(&iter)) != NULL){
+        ref->line += offset;
+    }
+    appendNodes(&state->pendingRefs, &from->pendingRefs);
+
+    //the part's own object is in its arena, so the arena is copied out before it is taken over
+    clearTable(&from->pool->strings);
+    Arena arena = from->pool->arena;
+    mergeArena(state->arena, &arena);
+
+    part->merged = true;
+}
+
+/** Function to free what is left of a part
+ *@param part - the part
+ **/
+static void clearPart(filePart* part){
+    clearTable(&part->state.xrefTable);
+    clearList(&part->state.pendingRefs);
+    if(!part->merged){
+        deleteGEDCOM(part->state.obj);
+    }
+}
+
+GEDCOMerror streamParallel(char* fileName, parseState* state, int flags){
+    GEDCOMerror error;
+    error.type = OK;
+    error.line = -1;
+
+    //the parts are read straight out of one mapping of the file
+    GEDCOMline head;
+    GEDCOMreader* reader = openStream(fileName, flags | LOAD_MMAP, &head, &error);
+    if(reader == NULL){
+        return error;
+    }
+
+    const char* data = reader->buffer;
+    size_t size = reader->size;
+
+    GEDCOMhandler handler;
+    handler.startRecord = &loadStartRecord;
+    handler.recordLine = &loadRecordLine;
+    handler.endRecord = &loadEndRecord;
+    handler.state = state;
+
+    //records start after the header, the rest of the file is only split if there is enough of it for several parts
+    size_t headerEnd = nextSplit(data, reader->start, size);
+    int threads = PARALLEL_THREADS;
+    if(threads <= 0){
+        long processors = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = processors > 0 ? (int)processors : 1;
+    }
+    size_t most = (size - headerEnd) / PARALLEL_MIN_PART;
+    int count = most < (size_t)threads ? (int)most : threads;
+    if(count <= 1){
+        headerEnd = size;
+    }
+
+    //the header is read first, as the parts need the submitter tag it names, and a file that is not split is read here whole
+    reader->end = headerEnd;
+    handler.startRecord(HEAD_RECORD, &head, reader->foldNumb, &error, state);
+
+    bool trailer = false;
+    recordType record = streamRecords(reader, &handler, HEAD_RECORD, headerEnd == size, &trailer, &error);
+    int offset = reader->lineNumb;
+    if(error.type == OK && !trailer && headerEnd < size){
+        handler.endRecord(record, offset + 1, &error, state);
+    }
+    if(error.type != OK || trailer || headerEnd == size){
+        deleteReader(reader);
+        return error;
+    }
+
+    filePart* parts = calloc(count, sizeof(filePart));
+    pthread_t* ids = malloc(sizeof(pthread_t) * count);
+    bool* started = calloc(count, sizeof(bool));
+    if(parts == NULL || ids == NULL || started == NULL){
+        free(parts);
+        free(ids);
+        free(started);
+        deleteReader(reader);
+        error.type = OTHER_ERROR;
+        return error;
+    }
+
+    //split into parts of about the same size, each starting at a record, records too big to split leave fewer parts
+    int made = 0;
+    size_t begin = headerEnd;
+    for(int i = 1; i <= count && begin < size; i++){
+        size_t end = i == count ? size : nextSplit(data, headerEnd + (size - headerEnd) / count * i, size);
+        if(end <= begin){
+            continue;
+        }
+
+        filePart* part = &parts[made++];
+        part->data = data + begin;
+        part->size = end - begin;
+        part->last = end == size;
+
+        initializeParseState(&part->state, flags);
+        strcpy(part->state.submTag, state->submTag);
+        part->state.charCheck = state->charCheck;
+        part->state.record = NO_RECORD;
+
+        begin = end;
+    }
+
+    //the calling thread takes the first part, a part whose thread could not be started is parsed after it
+    for(int i = 1; i < made; i++){
+        started[i] = pthread_create(&ids[i], NULL, &parsePart, &parts[i]) == 0;
+    }
+    parsePart(&parts[0]);
+    for(int i = 1; i < made; i++){
+        if(started[i]){
+            pthread_join(ids[i], NULL);
+        }
+        else{
+            parsePart(&parts[i]);
+        }
+    }
+
+    //the header has no individuals, so the table of tags can be made big enough for every part at once
+    if(getTableLength(state->xrefTable) == 0){
+        int tags = 0;
+        for(int i = 0; i < made; i++){
+            tags += getTableLength(parts[i].state.xrefTable);
+        }
+        HashTable sized = initializeTable(tags, state->xrefTable.hashKey, state->xrefTable.compareKeys, state->xrefTable.deleteData);
+        clearTable(&state->xrefTable);
+        state->xrefTable = sized;
+    }
+
+    //parts are joined in the order of the file, up to the first error or the trailer, as if read one after another
+    bool done = false;
+    for(int i = 0; i < made; i++){
+        filePart* part = &parts[i];
+        if(!done){
+            if(part->error.type != OK){
+                error = part->error;
+                if(error.line > 0){
+                    error.line += offset;
+                }
+                done = true;
+            }
+            else{
+                mergePart(state, part, offset);
+                offset += part->lines;
+                done = part->trailer;
+            }
+        }
+        clearPart(part);
+    }
+
+    free(parts);
+    free(ids);
+    free(started);
+    deleteReader(reader);
+
+    return error;
+}
+
+/** Function run by each thread of writeRecordsParallel, formats parts until there are none left
+ *@return NULL
+ *@param data - pointer to the writePool
+ **/
+static void* formatParts(void* data){
+    writePool* pool = (writePool*)data;
+
+    int part;
+    while((part = atomic_fetch_add(&pool->next, 1)) < pool->parts){
+        GEDCOMwriter* writer = createMemoryWriter();
+        if(writer != NULL){
+            int from = (int)((long)pool->count * part / pool->parts);
+            int to = (int)((long)pool->count * (part + 1) / pool->parts);
+            for(int i = from; i < to; i++){
+                writeRecord(writer, pool->records, i);
+            }
+        }
+        pool->formatted[part] = writer;
+    }
+
+    return NULL;
+}
+
+bool writeRecordsParallel(GEDCOMwriter* writer, const writeRecords* records, int threads){
+    int count = getVectorLength(records->individuals) + getVectorLength(records->families);
+
+    if(threads <= 0){
+        long processors = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = processors > 0 ? (int)processors : 1;
+    }
+
+    //a few parts for each thread, so one slow part does not leave the others waiting
+    int parts = count / PARALLEL_WRITE_RECORDS;
+    if(parts > threads * 4){
+        parts = threads * 4;
+    }
+    if(threads > parts){
+        threads = parts;
+    }
+
+    GEDCOMwriter** formatted = threads > 1 ? calloc(parts, sizeof(GEDCOMwriter*)) : NULL;
+    pthread_t* ids = threads > 1 ? malloc(sizeof(pthread_t) * threads) : NULL;
+    bool* started = threads > 1 ? calloc(threads, sizeof(bool)) : NULL;
+
+    //few records, one thread or no memory to spare are written straight to the file
+    if(formatted == NULL || ids == NULL || started == NULL){
+        free(formatted);
+        free(ids);
+        free(started);
+        for(int i = 0; i < count; i++){
+            writeRecord(writer, records, i);
+        }
+        return true;
+    }
+
+    writePool pool;
+    pool.records = records;
+    pool.count = count;
+    pool.parts = parts;
+    pool.formatted = formatted;
+    atomic_init(&pool.next, 0);
+
+    //the calling thread is one of the pool, a thread that could not be started just leaves more for the others
+    for(int t = 0; t < threads - 1; t++){
+        started[t] = pthread_create(&ids[t], NULL, &formatParts, &pool) == 0;
+    }
+    formatParts(&pool);
+    for(int t = 0; t < threads - 1; t++){
+        if(started[t]){
+            pthread_join(ids[t], NULL);
+        }
+    }
+
+    //parts are written in order, each in one go
+    bool complete = true;
+    for(int part = 0; part < parts; part++){
+        GEDCOMwriter* text = formatted[part];
+        if(text == NULL || text->failed){
+            complete = false;
+        }
+        else{
+            writeBytes(writer, text->buffer, text->used);
+        }
+        closeWriter(text);
+    }
+
+    free(formatted);
+    free(ids);
+    free(started);
+
+    return complete;
+}
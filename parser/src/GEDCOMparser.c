@@ -1,11 +1,17 @@
+#define _DEFAULT_SOURCE
+
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <unistd.h>
 
 #include "LinkedListAPI.h"
+#include "HashTableAPI.h"
+#include "GEDCOMreader.h"
 #include "GEDCOMparser.h"
 #include "GEDCOMutilities.h"
+#include "GEDCOMcache.h"
 
 //***************************************** GEDCOOM object functions *****************************************
 
@@ -22,614 +28,116 @@
  *@param a double pointer to a GEDCOMobject struct that needs to be allocated
  **/
 GEDCOMerror createGEDCOM(char* fileName, GEDCOMobject** obj){
+    return createGEDCOMflags(fileName, obj, LOAD_DEFAULT);
+}
+
+
+/** Function to create a GEDCOM object with non default loader options.
+ *@pre Same as createGEDCOM
+ *@post Same as createGEDCOM
+ *@return the error code indicating success or the error encountered when parsing the GEDCOM
+ *@param fileName - a string containing the name of the GEDCOM file
+ *@param a double pointer to a GEDCOMobject struct that needs to be allocated
+ *@param flags - LoadFlag values or'd together
+ **/
+GEDCOMerror createGEDCOMflags(char* fileName, GEDCOMobject** obj, int flags){
 
     GEDCOMerror error;
+    error.type = OK;
     error.line = -1;
     //check if filename exists
-    if(fileName == NULL){
-        error.type = INV_FILE;
-        return error;
-    }
-
-    FILE* inFile = fopen(fileName, "r");
-    char *token;
-    char *tag;
-    char submTag[32];
-    int submCheck = 0;
-    int lineNumb = 1;
-    int charCheck = 0;
-    char* line = malloc(sizeof(char)*256);
-    List tempStore = initializeList(&printIndividual, &destroyNodeData, &compareIndividuals);
-
-    //check if file was opened properly
-    if(inFile == NULL){
+    if(fileName == NULL || obj == NULL){
         error.type = INV_FILE;
-        free(inFile);
-        free(line);
         return error;
     }
+    *obj = NULL;
 
-    char* tempFile = malloc(sizeof(char) * (strlen(fileName) + 1));
-    strcpy(tempFile, fileName);
-
-    token = strtok(tempFile, ".");
-    if(token != NULL) {
-        token = strtok(NULL, ".");
+    //create required fields to start parsing
+    parseState state;
+    initializeParseState(&state, flags);
+
+    //the object is built from the records as the stream hands them out
+    GEDCOMhandler handler;
+    handler.startRecord = &loadStartRecord;
+    handler.recordLine = &loadRecordLine;
+    handler.endRecord = &loadEndRecord;
+    handler.state = &state;
+    if(flags & LOAD_PARALLEL){
+        error = streamParallel(fileName, &state, flags);
     }
-
-    //validate file tag
-    if(token == NULL || strcmp(token, "ged") != 0) {
-        free(tempFile);
-        fclose(inFile);
-        free(line);
-        error.type = INV_FILE;
-        return error;
+    else{
+        error = streamGEDCOM(fileName, &handler, flags);
     }
 
-    free(tempFile);
-
-    //check if the file is readable
-    if(!customFgets(line, 256, inFile, &error)) {
-        error.type = INV_FILE;
-        clearList(&tempStore);
-        free(line);
-        fclose(inFile);
-        return error;
-    }
-    char tempFirst[26];
-    strcpy(tempFirst, line);
-    token = strtok(tempFirst, " ");
-    int headNum = atoi(token);
-    token = strtok(NULL, " ");
-    if(headNum != 0 && strncmp(token,"HEAD",4) == 0){
-        error.type = INV_HEADER;
-        clearList(&tempStore);
-        free(line);
-        fclose(inFile);
-        return error;
-    }
-    //validate header first line
-    else if(strncmp(line,"0 HEAD", 6)!=0){
+    //submitter record must have been seen somewhere in the file
+    if(error.type == OK && state.obj->submitter == NULL){
         error.type = INV_GEDCOM;
-        clearList(&tempStore);
-        free(line);
-        fclose(inFile);
-        return error;
+        error.line = -1;
     }
 
-    //create required fields to start parsing
-    Header* header = malloc(sizeof(Header));
-    header->otherFields = initializeList(&printField, &deleteField, &compareFields);
-    GEDCOMobject* temp = malloc(sizeof(GEDCOMobject));
-    temp->individuals = initializeList(&printIndividual, &deleteIndividual, &compareIndividuals);
-    temp->families = initializeList(&printFamily, &deleteFamily, &compareFamilies);
-
-    while(1){
+    //patch the family references now that every individual is known
+    if(error.type == OK){
+        createFamilies(&state, &error);
+    }
 
-        customFgets(line, 256, inFile, &error);
-        lineNumb++;
-        if(error.type != OK){
-            //deleteGEDCOM(temp);
-            clearList(&tempStore);
-            free(line);
-            fclose(inFile);
-            error.type = INV_HEADER;
-            error.line = lineNumb;
-            return error;
-        }
-        contconcCheck(line, inFile, &lineNumb, &error);
-
-        //get GECOM file source
-        if(strncmp(line,"1 SOUR ", 6)==0){
-            token = tokenize(line);
-            if(token == NULL){
-                deleteGEDCOM(temp);
-                free(line);
-                clearList(&header->otherFields);
-                free(header);
-                fclose(inFile);
-                error.type = INV_HEADER;
-                error.line = lineNumb;
-                return error;
-            }
-            sprintf(header->source, "%s", token);
-        }
-        //parse GEDCOM version
-        else if(strncmp(line,"1 GEDC", 6)==0){
-            customFgets(line, 256, inFile, &error);
-            lineNumb++;
-            if(error.type != OK){
-                clearList(&tempStore);
-                free(line);
-                fclose(inFile);
-                error.type = INV_HEADER;
-                error.line = lineNumb;
-                return error;
-            }
-            contconcCheck(line, inFile, &lineNumb, &error);
-            if(strncmp(line,"2 VERS", 6)==0){
-                token = tokenize(line);
-                if(token == NULL){
-                    free(line);
-                    clearList(&header->otherFields);
-                    free(header);
-                    fclose(inFile);
-                    error.type = INV_HEADER;
-                    error.line = lineNumb;
-                    return error;
-                }
-                header->gedcVersion = atof(token);
-            }
-            else if(strstr(line,"VERS") != NULL){
-                clearList(&tempStore);
-                free(line);
-                fclose(inFile);
-                error.type = INV_RECORD;
-                error.line = lineNumb;
-                return error;
-            }
-        }
-        //parse char type of GEDCOM document
-        else if(strncmp(line,"1 CHAR",6) == 0){
-            charCheck = 1;
-            token = tokenize(line);
-            if(token == NULL){
-                clearList(&tempStore);
-                free(line);
-                fclose(inFile);
-                error.type = INV_HEADER;
-                error.line = lineNumb;
-                return error;
-            }
-            if(strncmp(token,"ANSEL", 5) == 0){
-                header->encoding = ANSEL;
-            }
-            else if(strncmp(token,"UTF-8", 5) == 0){
-                header->encoding = UTF8;
-            }
-             else if(strncmp(token,"UNICODE", 7) == 0){
-                header->encoding = UNICODE;
-            }
-            else if(strncmp(token,"ASCII", 5) == 0){
-                header->encoding = ASCII;
-            }
-            else{
-                clearList(&tempStore);
-                free(line);
-                fclose(inFile);
-                error.type = INV_HEADER;
-                error.line = lineNumb;
-                return error;
-            }
+    clearTable(&state.xrefTable);
+    clearList(&state.pendingRefs);
 
+    //the graph is built from the finished links
+    if(error.type == OK && (flags & LOAD_GRAPH)){
+        state.pool->graph = createFamilyGraph(state.obj);
+        if(state.pool->graph == NULL){
+            error.type = OTHER_ERROR;
+            error.line = -1;
         }
-        //check if submitter present
-        else if(strncmp(line,"1 SUBM",6) == 0){
-            token = tokenize(line);
-            submCheck = 1;
-            if(token == NULL){
-                clearList(&tempStore);
-                free(line);
-                fclose(inFile);
-                error.type = INV_HEADER;
-                error.line = lineNumb;
-                error.type = INV_HEADER;
-                error.line = lineNumb;
-                return error;
-            }
-            sprintf(submTag, "%s", token);
-        }
-        //break if header file over
-        else if(line[0] == '0'){
-            break;
-        }
-        else{
-            //insert header field if correct field
-            Field* field = malloc(sizeof(Field));
-            token = strtok(line, " ");
-            token = strtok(NULL, " ");
-            if(token == NULL){
-                clearList(&tempStore);
-                free(line);
-                fclose(inFile);
-                free(field);
-                error.type = INV_HEADER;
-                error.line = lineNumb;
-                return error;
-            }
-            field->tag = malloc(sizeof(char)* (strlen(token) + 1));
-            sprintf(field->tag, "%s", token);
-            token = strtok(NULL, "");
-            if(token == NULL){
-                clearList(&tempStore);
-                free(line);
-                fclose(inFile);
-                error.type = INV_HEADER;
-                error.line = lineNumb;
-                return error;
-            }
-            field->value = malloc(sizeof(char)* (strlen(token) + 1));
-            sprintf(field->value, "%s", token);
-            insertBack(&header->otherFields,field);
-        }
-
     }
 
-
-    //validate header fields
-    if(strlen(header->source) == 0 || header->gedcVersion == 0 || charCheck != 1 || submCheck == 0){
-        //deleteGEDCOM(temp);
-        clearList(&tempStore);
-        free(line);
-        fclose(inFile);
-        error.type = INV_HEADER;
-        error.line = lineNumb;
+    if(error.type != OK){
+        deleteGEDCOM(state.obj);
         return error;
     }
 
-    temp->header = header;
-    GEDCOMerror* temperror = malloc(sizeof(GEDCOMerror));
-    Submitter* submitter = createSubmitter(fileName, temperror, submTag);
-    if(temperror->type != OK){
-        //deleteGEDCOM(temp);
-        clearList(&tempStore);
-        free(line);
-        fclose(inFile);
-        return *temperror;
-    }
-    free(temperror);
-    header->submitter = submitter;
-    temp->submitter = submitter;
-    
-   while(1){
+    state.obj->header->submitter = state.obj->submitter;
+    *(obj) = state.obj;
 
-        if(line[0] == '0'){
-            //check if trailer and end parsing
-            if(strncmp(line,"0 TRLR", 6) == 0){
-                break;
-            }
-            //check if end of file
-            else if(feof(inFile)){
-                deleteGEDCOM(temp);
-                clearList(&tempStore);
-                free(line);
-                fclose(inFile);
-                error.type = INV_GEDCOM;
-                return error;
-            }
-            token = strtok(line, " ");
-            tag = strtok(NULL, " ");
-            token = strtok(NULL, "");
-            if(token== NULL){
-                return error;
-            }
-            if(strncmp(token,"INDI", 4) == 0){
-                Individual* indi = malloc(sizeof(Individual));
-                char tempTag[10];
-                strcpy(tempTag, tag);
-                indi->events = initializeList(&printEvent, &deleteEvent, &compareEvents);
-                indi->otherFields = initializeList(&printField, &deleteField, &compareFields);
-                indi->families = initializeList(&printFamily, &dummyDelete, &compareFamilies);
-                customFgets(line, 256, inFile, &error);
-                lineNumb++;
-                if(error.type != OK){
-                    deleteGEDCOM(temp);
-                    clearList(&tempStore);
-                    free(line);
-                    free(indi);
-                    fclose(inFile);
-                    error.type = INV_RECORD;
-                    error.line = lineNumb;
-                    return error;
-                }
-                contconcCheck(line, inFile, &lineNumb, &error);
-                while(1){
-                    if(strncmp(line,"1 NAME", 6) == 0){
-                        token = strtok(line, " ");
-                        token = strtok(NULL, " ");
-                        token = strtok(NULL, " /");
-                        if(token == NULL){
-                            indi->givenName = malloc(sizeof(char));
-                            strcpy(indi->givenName,"");
-                        }
-                        else{
-                            indi->givenName = malloc(sizeof(char)* (strlen(token) + 1));
-                            sprintf(indi->givenName, "%s", token);
-                        }
-                        token = strtok(NULL, " /");
-                        if(token == NULL){
-                            indi->surname = malloc(sizeof(char));
-                            strcpy(indi->surname,"");
-                        }
-                        else{
-                            indi->surname = malloc(sizeof(char)* (strlen(token) + 1));
-                            sprintf(indi->surname, "%s", token);
-                        }
-                        customFgets(line, 256, inFile, &error);
-                        lineNumb++;
-                        if(error.type != OK){
-                            deleteGEDCOM(temp);
-                            clearList(&tempStore);
-                            free(line);
-                            fclose(inFile);
-                            error.type = INV_RECORD;
-                            error.line = lineNumb;
-                            return error;
-                        }
-                        contconcCheck(line, inFile, &lineNumb, &error);
-                        continue;
-                    }
-
-                    if(line[0] == '0'){
-                        tagIndi* tempindi = malloc(sizeof(tagIndi));
-                        strncpy(tempindi->tag,tempTag, 25);
-                        tempindi->temp = indi;
-                        insertBack(&tempStore,tempindi);
-                        insertBack(&temp->individuals, indi);
-                        break;
-                    }
-
-                    customFgets(line, 256, inFile, &error);
-                        lineNumb++;
-                        if(error.type != OK){
-                            deleteGEDCOM(temp);
-                            clearList(&tempStore);
-                            free(line);
-                            fclose(inFile);
-                            error.type = INV_RECORD;
-                            error.line = lineNumb;
-                            return error;
-                        }
-                        contconcCheck(line, inFile, &lineNumb, &error);
-                        continue;
-
-                    /*token = strtok(line, " ");
-                    token = strtok(NULL, " ");
-
-                    if(token == NULL){
-                        deleteGEDCOM(temp);
-                        clearList(&tempStore);
-                        free(line);
-                        fclose(inFile);
-                        error.type = INV_RECORD;
-                        error.line = lineNumb;
-                        return error;
-                    }
-                    
-                    //check for individual event
-                   if(strncmp(token,"ADOP",4) == 0 || strncmp(token,"BIRT",4) == 0 || strncmp(token,"BAPM",4) == 0 || strncmp(token,"BARM",4) == 0 ||
-                        strncmp(token,"BASM",4) == 0 || strncmp(token,"BLES",4) == 0  || strncmp(token,"BURI",4) == 0  || strncmp(token,"CENS",4) == 0  
-                        || strncmp(token,"CHR",3) == 0 || strncmp(token,"CHRA",4) == 0 || strncmp(token,"CONF",4) == 0 || strncmp(token,"CREM",4) == 0 
-                        || strncmp(token,"DEAT",4) ==  0 || strncmp(token,"EMIG",4) == 0|| strncmp(token,"FCOM",4) == 0 || strncmp(token,"GRAD",4) == 0
-                        || strncmp(token,"IMMI",4) == 0 || strncmp(token,"NATU",4) == 0 || strncmp(token,"ORDN",4) == 0 || strncmp(token,"RETI",4) == 0 
-                        || strncmp(token,"PROB",4) == 0 || strncmp(token,"WILL",4) == 0 || strncmp(token,"EVEN",4) == 0 ){
-
-                        Event* event = malloc(sizeof(Event));
-                        event->otherFields = initializeList(&printField, &deleteField, &compareFields);
-                        strncpy(event->type, token, 4);
-                        while(1){
-                            customFgets(line, 256, inFile, &error);
-                            lineNumb++;
-                            if(error.type != OK){
-                                deleteGEDCOM(temp);
-                                clearList(&tempStore);
-                                free(line);
-                                clearList(&event->otherFields);
-                                free(event);
-                                fclose(inFile);
-                                error.type = INV_RECORD;
-                                error.line = lineNumb;
-                                return error;
-                            }
-                            contconcCheck(line, inFile, &lineNumb, &error);
-                            //if event record over break loop
-                            if(line[0] == '0' || line[0] == '1'){
-                                if(event->date == NULL){
-                                    event->date = malloc(sizeof(char));
-                                    strcpy(event->date,"");
-                                }
-                                if(event->place == NULL){
-                                    event->place = malloc(sizeof(char));
-                                    strcpy(event->place,"");
-                                }
-                                break;
-                            }
-                            //retrieve event date
-                            if(strncmp(line,"2 DATE",6) == 0){
-                                token = tokenize(line);
-                                if(token == NULL){
-                                    deleteGEDCOM(temp);
-                                    clearList(&tempStore);
-                                    free(line);
-                                    fclose(inFile);
-                                    if(event->place == NULL){
-                                        free(event->place);
-                                    }
-                                    free(event);
-                                    error.line = lineNumb;
-                                    error.type = INV_RECORD;
-                                    return error;
-                                }
-                                event->date = malloc(sizeof(char)* (strlen(token) + 1));
-                                sprintf(event->date, "%s", token);
-                            }
-                            //retrieve event place
-                            else if(strncmp(line,"2 PLAC",6) == 0){
-                                token = tokenize(line);
-                                if(token == NULL){
-                                    deleteGEDCOM(temp);
-                                    clearList(&tempStore);
-                                    free(line);
-                                    fclose(inFile);
-                                    if(event->date == NULL){
-                                        free(event->date);
-                                    }
-                                    free(event);
-                                    error.line = lineNumb;
-                                    error.type = INV_RECORD;
-                                    return error;
-                                }
-                                event->place = malloc(sizeof(char)* (strlen(token) + 1));
-                                sprintf(event->place, "%s", token);
-                            }
-                            else{
-                                //create appropariate event field if valid
-                                Field* field = malloc(sizeof(Field));
-                                token = strtok(line, " ");
-                                token = strtok(NULL, " ");
-                                if(token == NULL){
-                                    deleteGEDCOM(temp);
-                                    clearList(&tempStore);
-                                    free(line);
-                                    fclose(inFile);
-                                    free(field);
-                                    error.line = lineNumb;
-                                    error.type = INV_RECORD;
-                                    continue;
-                                }
-                                field->tag = malloc(sizeof(char)* (strlen(token) + 1));
-                                sprintf(field->tag, "%s", token);
-                                token = strtok(NULL, "");
-                                if(token == NULL){
-                                    free(field->tag);
-                                    free(field);
-                                    deleteGEDCOM(temp);
-                                    clearList(&tempStore);
-                                    free(line);
-                                    fclose(inFile);
-                                    error.line = lineNumb;
-                                    error.type = INV_RECORD;
-                                    continue;
-                                }
-                                field->value = malloc(sizeof(char)* (strlen(token) + 1));
-                                sprintf(field->value, "%s", token);
-                                insertBack(&event->otherFields,field);
-                            }
-                        }
-
-                        insertBack(&indi->events, event);
-                    }
-                    else if(strncmp(tag,"FAMS",4) == 0 || strncmp(tag,"FAMC",4) == 0){
-                            customFgets(line, 256, inFile, &error);
-                            lineNumb++;
-                            if(error.type != OK){
-                                deleteGEDCOM(temp);
-                                clearList(&tempStore);
-                                free(line);
-                                fclose(inFile);
-                                error.type = INV_RECORD;
-                                error.line = lineNumb;
-                                return error;
-                            }
-                            contconcCheck(line, inFile, &lineNumb, &error);
-                            continue;
-                    }
-                    else{
-                        //create appropariate individual field if valid
-                        Field* field = malloc(sizeof(Field));
-                        if(tag == NULL){
-                            deleteGEDCOM(temp);
-                            clearList(&tempStore);
-                            free(line);
-                            fclose(inFile);
-                            free(field);
-                            error.line  = lineNumb;
-                            error.type = INV_RECORD;
-                            return error;
-                        }
-                        field->tag = malloc(sizeof(char)* (strlen(token) + 1));
-                        sprintf(field->tag, "%s", tag);
-                        token = strtok(NULL, "");
-                        if(token == NULL){
-                            free(field->tag);
-                            free(field);
-                            deleteGEDCOM(temp);
-                            clearList(&tempStore);
-                            free(line);
-                            fclose(inFile);
-                            error.line  = lineNumb;
-                            error.type = INV_RECORD;
-                            return error;
-                        }
-                        field->value = malloc(sizeof(char)* (strlen(token) + 1));
-                        sprintf(field->value, "%s", token);
-                        insertBack(&indi->otherFields,field);
-                        customFgets(line, 256, inFile, &error);
-                        lineNumb++;
-                        if(error.type != OK){
-                            deleteGEDCOM(temp);
-                            clearList(&tempStore);
-                            free(line);
-                            fclose(inFile);
-                            error.type = INV_RECORD;
-                            error.line = lineNumb;
-                            return error;
-                        }
-                        contconcCheck(line, inFile, &lineNumb, &error);
-                    }*/
-                }
-            }
-            else{
-                customFgets(line, 256, inFile, &error);
-                lineNumb++;
-                if(error.type != OK){
-                    deleteGEDCOM(temp);
-                    clearList(&tempStore);
-                    free(line);
-                    fclose(inFile);
-                    error.type = INV_RECORD;
-                    error.line = lineNumb;
-                    return error;
-                }
-                contconcCheck(line, inFile, &lineNumb, &error);
-            }
-        }
-        //check if end of file and return error
-        else if(feof(inFile)){
-            clearList(&tempStore);
-            free(line);
-            fclose(inFile);
-            deleteGEDCOM(temp);
-            error.type = INV_GEDCOM;
-            return error;
-        }
-        else{
-            customFgets(line, 256, inFile, &error);
-            lineNumb++;
-            if(error.type != OK){
-                deleteGEDCOM(temp);
-                clearList(&tempStore);
-                free(line);
-                fclose(inFile);
-                error.type = INV_RECORD;
-                error.line = lineNumb;
-                return error;
-            }
-            contconcCheck(line, inFile, &lineNumb, &error);
-        }
+    error.type = OK;
+    error.line = -1;
+    return error;
 
-    }
+}
 
-    //create families for GEDCOM
-    createFamilies(temp,fileName,tempStore,&error);
 
-    if(error.type != OK){
-        deleteGEDCOM(temp);
-        clearList(&tempStore);
-        free(line);
-        fclose(inFile);
-        return error;
+void loadStartRecord(recordType type, const GEDCOMline* line, int lineNumb, GEDCOMerror* error, void* state){
+    //the header struct is made with the object, so only the records after it need one
+    if(type != HEAD_RECORD){
+        startRecord((parseState*)state, line, lineNumb, error);
     }
+}
 
-    //clear local variables and return object
-    clearList(&tempStore);
-    free(line);
-    fclose(inFile);
-    *(obj) = temp;
+void loadRecordLine(recordType type, const GEDCOMline* line, int lineNumb, GEDCOMerror* error, void* state){
+    parseState* loader = (parseState*)state;
 
-    error.type = OK;
-    return error;
+    //the loader's own record is used, a submitter other than the header's is skipped like an unknown record
+    if(loader->record == HEAD_RECORD){
+        parseHeaderLine(loader, line, lineNumb, error);
+    }
+    else if(loader->record == SUBM_RECORD){
+        parseSubmitterLine(loader, line, lineNumb, error);
+    }
+    else if(loader->record == INDI_RECORD){
+        parseIndividualLine(loader, line, lineNumb, error);
+    }
+    else if(loader->record == FAM_RECORD){
+        parseFamilyLine(loader, line, lineNumb, error);
+    }
+}
 
+void loadEndRecord(recordType type, int lineNumb, GEDCOMerror* error, void* state){
+    //header is over once the first record starts
+    if(type == HEAD_RECORD && !validateParsedHeader((parseState*)state)){
+        error->type = INV_HEADER;
+        error->line = lineNumb;
+    }
 }
 
 
@@ -645,46 +153,46 @@ char* printGEDCOM(const GEDCOMobject* obj){
         return NULL;
     }
 
-    //create readable version of GEDCOM
-    char* toReturn = malloc(sizeof(char) * 100000);
+    //create readable version of GEDCOM, it grows with the contents
+    growString str = initializeString();
     char* temp;
 
-    strcpy(toReturn, "GEDCOM object:\n");
-    strcat(toReturn, "Header:\n");
-    strcat(toReturn, "Header Source:\n");
-    strcat(toReturn, obj->header->source);
+    appendString(&str, "GEDCOM object:\n");
+    appendString(&str, "Header:\n");
+    appendString(&str, "Header Source:\n");
+    appendString(&str, obj->header->source);
     char tempged[25];
     sprintf(tempged,"\nGEDCOM version:\n%.2f\n", obj->header->gedcVersion);
-    strcat(toReturn, tempged);
-    strcat(toReturn, "Header Fields:\n");
+    appendString(&str, tempged);
+    appendString(&str, "Header Fields:\n");
     temp = toString(obj->header->otherFields);
-    strcat(toReturn, temp);
+    appendString(&str, temp);
     free(temp);
-    strcat(toReturn, "\nSubmitter:\n");
-    strcat(toReturn, "\nSubmitter Name:\n");
-    strcat(toReturn, obj->submitter->submitterName);
-    strcat(toReturn, "\nSubmitter Address:\n");
+    appendString(&str, "\nSubmitter:\n");
+    appendString(&str, "\nSubmitter Name:\n");
+    appendString(&str, obj->submitter->submitterName);
+    appendString(&str, "\nSubmitter Address:\n");
     if(strlen(obj->submitter->address) != 0){
-       strcat(toReturn, obj->submitter->address);
+       appendString(&str, obj->submitter->address);
     }
-    strcat(toReturn, "\nSubmitter Fields:\n");
+    appendString(&str, "\nSubmitter Fields:\n");
     temp = toString(obj->submitter->otherFields);
-    strcat(toReturn, temp);
+    appendString(&str, temp);
     free(temp);
-    strcat(toReturn,"\nIndividuals:\n");
+    appendString(&str,"\nIndividuals:\n");
     temp = toString(obj->individuals);
-    strcat(toReturn, temp);
+    appendString(&str, temp);
     free(temp);
-    strcat(toReturn,"\nFamilies:\n");
+    appendString(&str,"\nFamilies:\n");
     ListIterator iter = createIterator(obj->families);
     while(iter.current != NULL){
         char* temp = printFamily(iter.current->data);
-        strcat(toReturn, temp);
+        appendString(&str, temp);
         free(temp);
         nextElement(&iter);
     }
 
-    return toReturn;
+    return str.text;
 }
 
 
@@ -700,6 +208,15 @@ void deleteGEDCOM(GEDCOMobject* obj){
     if(obj == NULL){
         return;
     }
+
+    //an arena loaded object and everything in it go with its arena
+    if(obj->individuals.deleteData == &arenaDelete){
+        deleteFamilyGraph(((arenaObject*)obj)->graph);
+        clearTable(&((arenaObject*)obj)->strings);
+        Arena arena = ((arenaObject*)obj)->arena;
+        clearArena(&arena);
+        return;
+    }
     if(obj->submitter != NULL){
         clearList(&obj->submitter->otherFields);
         free(obj->submitter);
@@ -715,6 +232,26 @@ void deleteGEDCOM(GEDCOMobject* obj){
 }
 
 
+/** Function to get the memory statistics of a GEDCOM object
+ *@return the statistics.  Only objects loaded with LOAD_INTERN have string statistics, for any other object they are 0.
+ *@param obj - a pointer to a GEDCOMobject struct
+ **/
+GEDCOMstats getGEDCOMstats(const GEDCOMobject* obj){
+    GEDCOMstats stats;
+    memset(&stats, 0, sizeof(GEDCOMstats));
+
+    if(obj == NULL || obj->individuals.deleteData != &arenaDelete){
+        return stats;
+    }
+
+    const arenaObject* owner = (const arenaObject*)obj;
+    stats = owner->stats;
+    stats.arenaBytes = getArenaSize(owner->arena);
+
+    return stats;
+}
+
+
 /** Function to "convert" the GEDCOMerror into a humanly redabale string.
  *@return a string contaning a humanly readable representation of the error code
  *@param err - an error struct
@@ -819,34 +356,9 @@ List getDescendants(const GEDCOMobject* familyRecord, const Individual* person){
         return descendants;
     }
 
-    //create iterator for persons family
-    ListIterator iter = createIterator(person->families);
-    while(iter.current != NULL){
-        //check if person a adult of family
-        if((compareIndividuals(((Family*)iter.current->data)->husband,person) == 0 && cmpEvent(((Family*)iter.current->data)->husband,person)) || 
-            (compareIndividuals(((Family*)iter.current->data)->wife,person) == 0 && cmpEvent(((Family*)iter.current->data)->wife,person))){
-            //copy all children of the family
-            ListIterator iter1 = createIterator(((Family*)iter.current->data)->children);
-            while(iter1.current != NULL){
-                insertBack(&descendants, copyIndi((Individual*)iter1.current->data));
-                //recursive call to get descendants
-                List temp = getDescendants(familyRecord, (Individual*)iter1.current->data);
-                
-                //copy all descendants
-                ListIterator iter2 = createIterator(temp);
-                while(iter2.current != NULL){
-                    insertBack(&descendants, iter2.current->data); 
-                    nextElement(&iter2);
-                }
-                
-                temp.deleteData = &dummyDelete;
-                clearList(&temp);
-
-                nextElement(&iter1);
-            }
-        }
-        nextElement(&iter);
-    }
+    Vector start = adultFamilies(person, true);
+    traverseRelatives(familyRecord, person, &start, DESCENDANT_LINKS, 0, &collectRelative, &descendants);
+    clearVector(&start);
 
     return descendants;
 }
@@ -863,102 +375,164 @@ List getDescendants(const GEDCOMobject* familyRecord, const Individual* person){
  *@param obj - a pointer to a GEDCOMobject struct
  **/
 GEDCOMerror writeGEDCOM(char* fileName, const GEDCOMobject* obj){
+    return writeGEDCOMthreads(fileName, obj, 0);
+}
+
+
+/** Function to write a GEDCOMobject into a file in GEDCOM format, formatting the records on several threads.
+ *@pre Same as writeGEDCOM
+ *@post Same as writeGEDCOM
+ *@return the error code indicating success or the error encountered when writing the file
+ *@param fileName - a string containing the name of the file to write
+ *@param obj - a pointer to a GEDCOMobject struct
+ *@param threads - the most threads to use, 0 for one per processor
+ **/
+GEDCOMerror writeGEDCOMthreads(char* fileName, const GEDCOMobject* obj, int threads){
     GEDCOMerror error;
+    error.type = OK;
+    error.line = -1;
     if(fileName == NULL || obj == NULL){
         error.type = WRITE_ERROR;
         return error;
     }
 
-    int indCount = 0;
-    int famCount = 0;
-
-    List tempStore = initializeList(&printIndividual, &destroyNodeData, &compareIndividuals);
-    List tempFam = initializeList(&printIndividual, &destroyNodeData, &compareIndividuals);
-
-    FILE* outFile = fopen(fileName, "w");
-
-    if(outFile == NULL){
+    //an object that cannot be written is turned down before the file is touched
+    if(obj->header == NULL || obj->submitter == NULL || strlen(obj->header->source) == 0 || obj->header->gedcVersion == 0){
         error.type = WRITE_ERROR;
         return error;
     }
 
-    fprintf(outFile, "0 HEAD\n");
-    if(strlen(obj->header->source) == 0){
+    GEDCOMwriter* writer = createWriter(fileName);
+    if(writer == NULL){
         error.type = WRITE_ERROR;
         return error;
     }
-    fprintf(outFile, "1 SOUR %s\n", obj->header->source);
-    fprintf(outFile, "1 GEDC\n");
-    fprintf(outFile, "2 VERS %.2lf\n", obj->header->gedcVersion);
-    if(obj->header->gedcVersion == 0){
-        error.type = WRITE_ERROR;
-        return error;
-    }
-    fprintf(outFile, "2 FORM LINEAGE-LINKED\n");
+
+    int indCount = 0;
+    int famCount = 0;
+
+    writeText(writer, "0 HEAD\n");
+    writeValueLine(writer, "1 SOUR ", obj->header->source);
+    writeText(writer, "1 GEDC\n");
+    char version[32];
+    snprintf(version, sizeof(version), "%.2lf", obj->header->gedcVersion);
+    writeValueLine(writer, "2 VERS ", version);
+    writeText(writer, "2 FORM LINEAGE-LINKED\n");
     if(obj->header->encoding == ANSEL){
-        fprintf(outFile, "1 CHAR ANSEL\n");
+        writeText(writer, "1 CHAR ANSEL\n");
     }
     else if(obj->header->encoding == UTF8){
-        fprintf(outFile, "1 CHAR UTF-8\n");
+        writeText(writer, "1 CHAR UTF-8\n");
     }
     else if(obj->header->encoding == UNICODE){
-        fprintf(outFile, "1 CHAR UNICODE\n");
+        writeText(writer, "1 CHAR UNICODE\n");
     }
     else if(obj->header->encoding == ASCII){
-        fprintf(outFile, "1 CHAR ASCII\n");
+        writeText(writer, "1 CHAR ASCII\n");
     }
-    fprintf(outFile, "1 SUBM @SUBM1@\n");
-    fprintf(outFile, "0 @SUBM1@ SUBM\n");
-    fprintf(outFile, "1 NAME %s\n", obj->submitter->submitterName);
+    writeText(writer, "1 SUBM @SUBM1@\n");
+    writeText(writer, "0 @SUBM1@ SUBM\n");
+    writeValueLine(writer, "1 NAME ", obj->submitter->submitterName);
     if(strcmp(obj->submitter->address,"") != 0){
-        fprintf(outFile, "1 ADDR %s\n", obj->submitter->address);
+        writeValueLine(writer, "1 ADDR ", obj->submitter->address);
     }
 
-    ListIterator iter = createIterator(obj->individuals);
-    while(iter.current != NULL){
-        Individual* indi = (Individual*)iter.current->data;
-        fprintf(outFile, "0 @I%04d@ INDI\n", indCount);
+    //records are walked from contiguous arrays, an individual's number is its index
+    writeRecords records;
+    records.individuals = listToVector(obj->individuals);
+    records.families = listToVector(obj->families);
+    Vector* individuals = &records.individuals;
+    Vector* families = &records.families;
 
-        storeIndi* tempindi = malloc(sizeof(storeIndi));
-        tempindi->num = indCount;
-        tempindi->temp = indi;
+    //every record is numbered before anything is written, and the numbers are looked up by address
+    records.indiNumbers = initializeTable(getVectorLength(*individuals), &hashPointer, &comparePointers, &dummyDelete);
+    records.famNumbers = initializeTable(getVectorLength(*families), &hashPointer, &comparePointers, &dummyDelete);
+    storeIndi* indiNums = malloc(sizeof(storeIndi) * (getVectorLength(*individuals) + 1));
+    Arena famNums = initializeArena();
 
-        insertBack(&tempStore, tempindi);
+    //families are numbered in the order the individuals link to them, then any that nobody links to
+    for(indCount = 0; indCount < getVectorLength(*individuals); indCount++){
+        Individual* indi = (Individual*)getVectorElement(*individuals, indCount);
+        indiNums[indCount].num = indCount;
+        indiNums[indCount].temp = indi;
+        insertTable(&records.indiNumbers, indi, &indiNums[indCount]);
 
-        fprintf(outFile, "1 NAME %s /%s/\n", indi->givenName, indi->surname);
-        if(findElement(indi->otherFields, &findTag ,"GIVN") != NULL){
-            if(strlen(indi->givenName)==0){
-                fprintf(outFile, "2 GIVN Unknown\n");
-            }
-            else{
-                fprintf(outFile, "2 GIVN %s\n", indi->givenName);
+        ListIterator familyIter = createIterator(indi->families);
+        Family* indiFamily;
+        while((indiFamily = (Family*)nextElement(&familyIter)) != NULL){
+            if(lookupTable(records.famNumbers, indiFamily) == NULL){
+                storeFam* tempfam = arenaAlloc(&famNums, sizeof(storeFam));
+                tempfam->num = famCount++;
+                tempfam->temp = indiFamily;
+                insertTable(&records.famNumbers, indiFamily, tempfam);
             }
         }
+    }
+    for(int i = 0; i < getVectorLength(*families); i++){
+        Family* family = (Family*)getVectorElement(*families, i);
+        if(lookupTable(records.famNumbers, family) == NULL){
+            storeFam* tempfam = arenaAlloc(&famNums, sizeof(storeFam));
+            tempfam->num = famCount++;
+            tempfam->temp = family;
+            insertTable(&records.famNumbers, family, tempfam);
+        }
+    }
+
+    //the records only read the numbers, so they can be formatted apart from each other
+    bool written = writeRecordsParallel(writer, &records, threads);
+
+    writeText(writer, "0 TRLR\n");
+
+    if(!closeWriter(writer) || !written){
+        error.type = WRITE_ERROR;
+    }
+    clearTable(&records.indiNumbers);
+    clearTable(&records.famNumbers);
+    clearArena(&famNums);
+    free(indiNums);
+    clearVector(individuals);
+    clearVector(families);
+
+    return error;
+}
+
+void writeRecord(GEDCOMwriter* writer, const writeRecords* records, int index){
+    int indiLength = getVectorLength(records->individuals);
+
+    if(index < indiLength){
+        Individual* indi = (Individual*)getVectorElement(records->individuals, index);
+        writeXrefLine(writer, "0 ", 'I', index, 4, " INDI");
+
+        writeText(writer, "1 NAME ");
+        writeText(writer, indi->givenName);
+        writeText(writer, " /");
+        writeText(writer, indi->surname);
+        writeText(writer, "/\n");
+        if(findElement(indi->otherFields, &findTag ,"GIVN") != NULL){
+            writeValueLine(writer, "2 GIVN ", strlen(indi->givenName) == 0 ? "Unknown" : indi->givenName);
+        }
         if(findElement(indi->otherFields, &findTag ,"SURN") != NULL){
-            if(strlen(indi->surname)==0){
-                fprintf(outFile, "2 SURN Unknown\n");
-            }
-            else{
-                fprintf(outFile, "2 SURN %s\n", indi->surname);
-            }
+            writeValueLine(writer, "2 SURN ", strlen(indi->surname) == 0 ? "Unknown" : indi->surname);
         }
         ListIterator fieldIter = createIterator(indi->otherFields);
         while(fieldIter.current != NULL){
             Field* indiField = (Field*)fieldIter.current->data;
             if(strcmp(indiField->tag,"GIVN") != 0 && strcmp(indiField->tag,"SURN") != 0){
-                fprintf(outFile, "1 %s %s\n", indiField->tag, indiField->value);
+                writeText(writer, "1 ");
+                writeText(writer, indiField->tag);
+                writeValueLine(writer, " ", indiField->value);
             }
             nextElement(&fieldIter);
         }
         ListIterator eventIter = createIterator(indi->events);
         while(eventIter.current != NULL){
             Event* indiEvent = (Event*)eventIter.current->data;
-            fprintf(outFile, "1 %s\n", indiEvent->type);
+            writeValueLine(writer, "1 ", indiEvent->type);
             if(strcmp(indiEvent->date,"") != 0){
-                fprintf(outFile, "2 DATE %s\n", indiEvent->date);
+                writeValueLine(writer, "2 DATE ", indiEvent->date);
             }
             if(strcmp(indiEvent->place,"") != 0){
-                fprintf(outFile, "2 PLAC %s\n", indiEvent->place);
+                writeValueLine(writer, "2 PLAC ", indiEvent->place);
             }
             nextElement(&eventIter);
         }
@@ -966,80 +540,162 @@ GEDCOMerror writeGEDCOM(char* fileName, const GEDCOMobject* obj){
         ListIterator familyIter = createIterator(indi->families);
         while(familyIter.current != NULL){
             Family* indiFamily = (Family*)familyIter.current->data;
-            if(findElement(tempFam,&findFamily,indiFamily) == NULL){
-                storeFam* tempfam = malloc(sizeof(storeFam));
-                tempfam->num = famCount;
-                famCount++;
-                tempfam->temp = indiFamily;
-                insertBack(&tempFam, tempfam);
-            }
+            int famNum = ((storeFam*)lookupTable(records->famNumbers, indiFamily))->num;
             if(indiFamily->husband != NULL){
                 if(compareIndividuals(indiFamily->husband,indi) == 0){
-                    fprintf(outFile, "1 FAMS @F%03d@\n", ((storeFam*)findElement(tempFam,&findFamily,indiFamily))->num);
+                    writeXrefLine(writer, "1 FAMS ", 'F', famNum, 3, "");
                 }
             }
             else if(indiFamily->wife != NULL){
                 if(compareIndividuals(indiFamily->wife,indi) == 0){
-                    fprintf(outFile, "1 FAMS @F%03d@\n", ((storeFam*)findElement(tempFam,&findFamily,indiFamily))->num);
+                    writeXrefLine(writer, "1 FAMS ", 'F', famNum, 3, "");
                 }
 
             }
             else{
-                fprintf(outFile, "1 FAMC @F%03d@\n", ((storeFam*)findElement(tempFam,&findFamily,indiFamily))->num);
+                writeXrefLine(writer, "1 FAMC ", 'F', famNum, 3, "");
             }
             nextElement(&familyIter);
-        }        
-        nextElement(&iter);
-        indCount++;
+        }
+        return;
     }
 
-    ListIterator familyIter = createIterator(obj->families);
-    while(familyIter.current != NULL){
-        Family* family = (Family*)familyIter.current->data;
-        Individual* husband = family->husband;
-        Individual* wife = family->wife;
-        if(findElement(tempFam,&findFamily,family) == NULL){
-            fprintf(outFile, "0 @F000@ FAM\n");
-        }
-        else{
-            fprintf(outFile, "0 @F%03d@ FAM\n", ((storeFam*)findElement(tempFam,&findFamily,family))->num);
-        }
-        if(husband != NULL){
-            fprintf(outFile, "1 HUSB @I%04d@\n", ((storeIndi*)findElement(tempStore,&findIndividual,husband))->num);
-        }
-        if(wife != NULL){
-            fprintf(outFile, "1 WIFE @I%04d@\n", ((storeIndi*)findElement(tempStore,&findIndividual,wife))->num);
+    Family* family = (Family*)getVectorElement(records->families, index - indiLength);
+    Individual* husband = family->husband;
+    Individual* wife = family->wife;
+    writeXrefLine(writer, "0 ", 'F', ((storeFam*)lookupTable(records->famNumbers, family))->num, 3, " FAM");
+    storeIndi* husbandNum = (storeIndi*)lookupTable(records->indiNumbers, husband);
+    storeIndi* wifeNum = (storeIndi*)lookupTable(records->indiNumbers, wife);
+    if(husbandNum != NULL){
+        writeXrefLine(writer, "1 HUSB ", 'I', husbandNum->num, 4, "");
+    }
+    if(wifeNum != NULL){
+        writeXrefLine(writer, "1 WIFE ", 'I', wifeNum->num, 4, "");
+    }
+
+    ListIterator childIter = createIterator(family->children);
+    while(childIter.current != NULL){
+        storeIndi* childNum = (storeIndi*)lookupTable(records->indiNumbers, childIter.current->data);
+        if(childNum != NULL){
+            writeXrefLine(writer, "1 CHIL ", 'I', childNum->num, 4, "");
         }
+        nextElement(&childIter);
+    }
+}
 
-        /*ListIterator eventIter = createIterator(family->events);
-        while(eventIter.current != NULL){
-            Event* indiEvent = (Event*)eventIter.current->data;
-            fprintf(outFile, "1 %s\n", indiEvent->type);
-            if(strcmp(indiEvent->date,"") == 0){
-                fprintf(outFile, "2 DATE %s\n", indiEvent->date);
-            }
-            if(strcmp(indiEvent->date,"") == 0){
-                fprintf(outFile, "2 PLAC %s\n", indiEvent->place);
-            }
-            nextElement(&eventIter);
-        }*/
+void writeValueLine(GEDCOMwriter* writer, const char* start, const char* value){
+    writeText(writer, start);
+    writeText(writer, value);
+    writeBytes(writer, "\n", 1);
+}
+
+void writeXrefLine(GEDCOMwriter* writer, const char* start, char kind, int number, int width, const char* end){
+    char xref[2] = {'@', kind};
+    writeText(writer, start);
+    writeBytes(writer, xref, 2);
+    writeNumber(writer, number, width);
+    writeBytes(writer, "@", 1);
+    writeText(writer, end);
+    writeBytes(writer, "\n", 1);
+}
+
+/** Function to add an individual with just a given name and surname to the end of a GEDCOM file, without rewriting it.
+ *@pre File exists and is a GEDCOM file that ends with a TRLR record
+ *@post The new INDI record has been written over the trailer, followed by a new trailer
+ *@return the error code indicating success or the error encountered when writing the file
+ *@param fileName - a string containing the name of the GEDCOM file
+ *@param firstname - given name
+ *@param lastname - surname
+ **/
+GEDCOMerror appendIndividual(char* fileName, const char* firstname, const char* lastname){
+    GEDCOMerror error;
+    error.type = OK;
+    error.line = -1;
+
+    if(fileName == NULL || firstname == NULL || lastname == NULL){
+        error.type = WRITE_ERROR;
+        return error;
+    }
+
+    if(!validNewName(firstname, lastname)){
+        error.type = INV_RECORD;
+        return error;
+    }
+
+    int number = largestIndividualNumber(fileName);
+    if(number < -1){
+        error.type = INV_FILE;
+        return error;
+    }
+
+    FILE* file = fopen(fileName, "r+b");
+    if(file == NULL){
+        error.type = INV_FILE;
+        return error;
+    }
 
-        ListIterator childIter = createIterator(family->children);
-        while(childIter.current != NULL){
-            Individual* child = (Individual*)childIter.current->data;
-            fprintf(outFile, "1 CHIL @I%04d@\n", ((storeIndi*)findElement(tempStore,&findIndividual,child))->num);
-            nextElement(&childIter);
+    char tail[APPEND_TAIL + 1];
+    long size;
+    if(fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) < 0){
+        fclose(file);
+        error.type = WRITE_ERROR;
+        return error;
+    }
+
+    //the trailer is the last record, so the file is read backwards only as far as its last line that is not blank
+    long end = size;
+    bool blank = true;
+    while(end > 0 && blank){
+        long start = end > APPEND_TAIL ? end - APPEND_TAIL : 0;
+        if(fseek(file, start, SEEK_SET) != 0 || fread(tail, 1, end - start, file) != (size_t)(end - start)){
+            fclose(file);
+            error.type = WRITE_ERROR;
+            return error;
+        }
+
+        char last = tail[end - start - 1];
+        while(end > start && (last == '\r' || last == '\n' || last == ' ' || last == '\t')){
+            end--;
+            last = end > start ? tail[end - start - 1] : '\0';
         }
+        blank = end == start;
+    }
 
-        nextElement(&familyIter);
+    //the trailer ends the text, and the terminator after it is kept for the new lines
+    long tailStart = end > APPEND_TAIL - 2 ? end - (APPEND_TAIL - 2) : 0;
+    long tailEnd = size - end > 2 ? end + 2 : size;
+    if(fseek(file, tailStart, SEEK_SET) != 0 || fread(tail, 1, tailEnd - tailStart, file) != (size_t)(tailEnd - tailStart)){
+        fclose(file);
+        error.type = WRITE_ERROR;
+        return error;
     }
+    size_t tailLength = tailEnd - tailStart;
+    tail[tailLength] = '\0';
 
-    fprintf(outFile, "0 TRLR\n");
+    const char* eol = "\n";
+    long trailer = findTrailer(tail, tailLength, &eol);
+    if(trailer < 0){
+        fclose(file);
+        error.type = INV_GEDCOM;
+        return error;
+    }
 
-    error.type = OK;
-    fclose(outFile);
-    clearList(&tempFam);
-    clearList(&tempStore);
+    if(fseek(file, tailStart + trailer, SEEK_SET) != 0
+       || fprintf(file, "0 @I%04d@ INDI%s", number + 1, eol) < 0
+       || fprintf(file, "1 NAME %s /%s/%s", firstname, lastname, eol) < 0
+       || fprintf(file, "0 TRLR%s", eol) < 0){
+        fclose(file);
+        error.type = WRITE_ERROR;
+        return error;
+    }
+
+    long written = ftell(file);
+    if(written < 0 || fflush(file) != 0 || ftruncate(fileno(file), written) != 0){
+        error.type = WRITE_ERROR;
+    }
+    if(fclose(file) != 0){
+        error.type = WRITE_ERROR;
+    }
 
     return error;
 }
@@ -1186,24 +842,18 @@ ErrorCode validateGEDCOM(const GEDCOMobject* obj){
 
 List getDescendantListN(const GEDCOMobject* familyRecord, const Individual* person, unsigned int maxGen){
 
-    List descendants = initializeList(&printGeneration, &deleteGeneration, &compareGenerations);
+    //generations are collected by index and only become a List of Lists at the end
+    Vector generations = initializeVector(&printGeneration, &dummyDelete, &compareGenerations);
 
     if(person == NULL){
-        return descendants;
+        return finishGenerations(&generations);
     } 
             
-    Family *family;
-    ListIterator iter = createIterator(person->families);
-    while(iter.current != NULL){
-        family = (Family*)iter.current->data;
-        if(compareIndividuals(family->wife,person) == 0  || compareIndividuals(family->husband,person) == 0){
-            recursiveDescendant(&descendants, family, maxGen, 1);
-        }
-
-        nextElement(&iter);
-    }
+    Vector start = adultFamilies(person, false);
+    traverseRelatives(familyRecord, person, &start, DESCENDANT_LINKS, maxGen, &collectGeneration, &generations);
+    clearVector(&start);
 
-    return descendants;
+    return finishGenerations(&generations);
 
 }
 
@@ -1219,54 +869,206 @@ List getDescendantListN(const GEDCOMobject* familyRecord, const Individual* pers
 
 List getAncestorListN(const GEDCOMobject* familyRecord, const Individual* person, int maxGen){
 
-    List descendants = initializeList(&printGeneration, &deleteGeneration, &compareGenerations);
+    Vector generations = initializeVector(&printGeneration, &dummyDelete, &compareGenerations);
 
     if(person == NULL){
-        return descendants;
+        return finishGenerations(&generations);
     } 
 
-    Family *family;
-    ListIterator iter = createIterator(person->families);
-    while(iter.current != NULL){
-        family = (Family*)iter.current->data;
-        if(family->wife != person && family->husband != person){
-            recursiveAnscestor(&descendants, family, maxGen, 1);
-        }
-        nextElement(&iter);
-    }
-
+    Vector start = childFamilies(person);
+    traverseRelatives(familyRecord, person, &start, ANCESTOR_LINKS, maxGen, &collectGeneration, &generations);
+    clearVector(&start);
 
-     return descendants;
+    return finishGenerations(&generations);
 
 }
 
-/** Function for converting an Individual struct into a JSON string
- *@pre Individual exists, is not null, and is valid
- *@post Individual has not been modified in any way, and a JSON string has been created
- *@return newly allocated JSON string.  May be NULL.
- *@param ind - a pointer to an Individual struct
- **/
-char* indToJSON(const Individual* ind){
-    if(ind == NULL){
-        char* toReturn = malloc(sizeof(char));
-        strcpy(toReturn,"\0");
-        return toReturn;
+/** Function to return a list of all descendants of an individual in a GEDCOM, without copying them
+ *@pre GEDCOM object exists, is not null, and is valid
+ *@post GEDCOM object has not been modified in any way, and a list of descendants has been created
+ *@return a list of descendants, in the same order getDescendants returns them.  All list members are const Individual*
+ *pointing at the records in the GEDCOM object, so they are only valid while the object is.  Freeing the list does not free them.
+ *@param familyRecord - a pointer to a GEDCOMobject struct
+ *@param person - the Individual record whose descendants we want
+ **/
+List getDescendantsView(const GEDCOMobject* familyRecord, const Individual* person){
+    List descendants = initializeList(&printIndividual, &dummyDelete, &compareIndividuals);
+
+    if(familyRecord == NULL || person == NULL){
+        return descendants;
     }
 
-    char* toReturn = malloc(sizeof(char)* 302);
+    Vector start = adultFamilies(person, true);
+    traverseRelatives(familyRecord, person, &start, DESCENDANT_LINKS, 0, &collectRelativeView, &descendants);
+    clearVector(&start);
+
+    return descendants;
+}
+
+/** Function to return a list of up to N generations of descendants of an individual in a GEDCOM, without copying them
+ *@pre GEDCOM object exists, is not null, and is valid
+ *@post GEDCOM object has not been modified in any way, and a list of descendants has been created
+ *@return a list of generations like getDescendantListN.  The members of each generation are const Individual*
+ *pointing at the records in the GEDCOM object, so they are only valid while the object is.
+ *@param familyRecord - a pointer to a GEDCOMobject struct
+ *@param person - the Individual record whose descendants we want
+ *@param maxGen - maximum number of generations to examine, 0 for all of them
+ **/
+List getDescendantListNView(const GEDCOMobject* familyRecord, const Individual* person, unsigned int maxGen){
+    Vector generations = initializeVector(&printGeneration, &dummyDelete, &compareGenerations);
 
-    strcpy(toReturn, "{\"givenName\":\"\0");
-    if(ind->givenName == NULL){
+    if(person == NULL){
+        return finishGenerations(&generations);
     }
-    else{
-        strcat(toReturn, ind->givenName);
+
+    Vector start = adultFamilies(person, false);
+    traverseRelatives(familyRecord, person, &start, DESCENDANT_LINKS, maxGen, &collectGenerationView, &generations);
+    clearVector(&start);
+
+    return finishGenerations(&generations);
+}
+
+/** Function to return a list of up to N generations of ancestors of an individual in a GEDCOM, without copying them
+ *@pre GEDCOM object exists, is not null, and is valid
+ *@post GEDCOM object has not been modified in any way, and a list of ancestors has been created
+ *@return a list of generations like getAncestorListN.  The members of each generation are const Individual*
+ *pointing at the records in the GEDCOM object, so they are only valid while the object is.
+ *@param familyRecord - a pointer to a GEDCOMobject struct
+ *@param person - the Individual record whose ancestors we want
+ *@param maxGen - maximum number of generations to examine, 0 for all of them
+ **/
+List getAncestorListNView(const GEDCOMobject* familyRecord, const Individual* person, int maxGen){
+    Vector generations = initializeVector(&printGeneration, &dummyDelete, &compareGenerations);
+
+    if(person == NULL){
+        return finishGenerations(&generations);
     }
-    strcat(toReturn, "\",\"surname\":\"");
-    if(ind->surname == NULL){
+
+    Vector start = childFamilies(person);
+    traverseRelatives(familyRecord, person, &start, ANCESTOR_LINKS, maxGen, &collectGenerationView, &generations);
+    clearVector(&start);
+
+    return finishGenerations(&generations);
+}
+
+/** Function to find how two individuals in a GEDCOM are related through their common ancestors
+ *@pre GEDCOM object exists, is not null, and is valid
+ *@post GEDCOM object has not been modified in any way
+ *@return the relationship, which must be freed with clearRelationship
+ *@param familyRecord - a pointer to a GEDCOMobject struct
+ *@param first - the first Individual record
+ *@param second - the second Individual record
+ **/
+Relationship findRelationship(const GEDCOMobject* familyRecord, const Individual* first, const Individual* second){
+    Relationship relationship;
+    relationship.ancestors = initializeList(&printIndividual, &dummyDelete, &compareIndividuals);
+    relationship.path = initializeList(&printIndividual, &dummyDelete, &compareIndividuals);
+    relationship.firstDistance = -1;
+    relationship.secondDistance = -1;
+
+    if(first == NULL || second == NULL){
+        return relationship;
     }
-    else{
-        strcat(toReturn, ind->surname);
+
+    const FamilyGraph* graph = getFamilyGraph(familyRecord);
+    searchSide sides[2];
+    initializeSearchSide(&sides[0], first);
+    initializeSearchSide(&sides[1], second);
+
+    //common ancestors in the order they are found, with the smallest total distance so far
+    Vector meetings = initializeVector(&printIndividual, &dummyDelete, &compareIndividuals);
+    int best = -1;
+    if(first == second){
+        insertBackVector(&meetings, (Individual*)first);
+        best = 0;
+    }
+
+    //an ancestor neither side has reached yet is more than depth generations away from one of them,
+    //so once both sides are that deep or have run out nothing closer than best is left
+    while(1){
+        int side = -1;
+        for(int i = 0; i < 2; i++){
+            if(getVectorLength(sides[i].frontier) == 0 || (best >= 0 && sides[i].depth >= best)){
+                continue;
+            }
+            if(side < 0 || getVectorLength(sides[i].frontier) < getVectorLength(sides[side].frontier)){
+                side = i;
+            }
+        }
+        if(side < 0){
+            break;
+        }
+
+        expandSearchSide(graph, &sides[side], &sides[1 - side], &meetings, &best);
+    }
+
+    VectorIterator iter = createVectorIterator(meetings);
+    Individual* meeting;
+    while((meeting = (Individual*)nextVectorElement(&iter)) != NULL){
+        relativeStep* up = (relativeStep*)lookupTable(sides[0].reached, meeting);
+        relativeStep* down = (relativeStep*)lookupTable(sides[1].reached, meeting);
+        if(up->distance + down->distance != best){
+            continue;
+        }
+
+        insertBack(&relationship.ancestors, meeting);
+        if(getLength(relationship.path) > 0){
+            continue;
+        }
+
+        //the path is built outwards from the first common ancestor
+        relationship.firstDistance = up->distance;
+        relationship.secondDistance = down->distance;
+        for(relativeStep* step = up; step != NULL; step = (relativeStep*)lookupTable(sides[0].reached, step->from)){
+            insertFront(&relationship.path, step->individual);
+        }
+        for(relativeStep* step = (relativeStep*)lookupTable(sides[1].reached, down->from); step != NULL; step = (relativeStep*)lookupTable(sides[1].reached, step->from)){
+            insertBack(&relationship.path, step->individual);
+        }
+    }
+
+    clearVector(&meetings);
+    clearSearchSide(&sides[0]);
+    clearSearchSide(&sides[1]);
+
+    return relationship;
+}
+
+/** Function to free the lists of a Relationship.  The individuals in them belong to the GEDCOM object and are not freed.
+ *@param relationship - a pointer to the Relationship struct
+ **/
+void clearRelationship(Relationship* relationship){
+    if(relationship == NULL){
+        return;
+    }
+
+    clearList(&relationship->ancestors);
+    clearList(&relationship->path);
+    relationship->firstDistance = -1;
+    relationship->secondDistance = -1;
+}
+
+/** Function for converting an Individual struct into a JSON string
+ *@pre Individual exists, is not null, and is valid
+ *@post Individual has not been modified in any way, and a JSON string has been created
+ *@return newly allocated JSON string.  May be NULL.
+ *@param ind - a pointer to an Individual struct
+ **/
+char* indToJSON(const Individual* ind){
+    if(ind == NULL){
+        char* toReturn = malloc(sizeof(char));
+        strcpy(toReturn,"\0");
+        return toReturn;
     }
+
+    const char* givenName = ind->givenName == NULL ? "" : ind->givenName;
+    const char* surname = ind->surname == NULL ? "" : ind->surname;
+    char* toReturn = malloc(sizeof(char) * (strlen(givenName) + strlen(surname) + 30));
+
+    strcpy(toReturn, "{\"givenName\":\"");
+    strcat(toReturn, givenName);
+    strcat(toReturn, "\",\"surname\":\"");
+    strcat(toReturn, surname);
     strcat(toReturn, "\"}");
 
     return toReturn;
@@ -1331,90 +1133,160 @@ Individual* JSONtoInd(const char* str){
     return indi;
 }
 
-void JSONaddindi(char* fileName, char* firstname, char* lastname){
-    GEDCOMobject* gedcomObject = NULL;
-    createGEDCOM(fileName, &gedcomObject);
+bool validNewName(const char* firstname, const char* lastname){
+    if(firstname == NULL || lastname == NULL){
+        return false;
+    }
+
+    //the name has to come back as the same name, on one line the loader accepts
+    return strpbrk(firstname, "\r\n/") == NULL && strpbrk(lastname, "\r\n/") == NULL && strlen("1 NAME  //") + strlen(firstname) + strlen(lastname) <= 255;
+}
 
+Individual* createNamedIndividual(const char* firstname, const char* lastname){
     Individual* toReturn = malloc(sizeof(Individual));
+    char* givenName = malloc(sizeof(char)*(strlen(firstname)+1));
+    char* surname = malloc(sizeof(char)*(strlen(lastname)+1));
+    if(toReturn == NULL || givenName == NULL || surname == NULL){
+        free(toReturn);
+        free(givenName);
+        free(surname);
+        return NULL;
+    }
 
     toReturn->events = initializeList(&printEvent, &deleteEvent, &compareEvents);
     toReturn->otherFields = initializeList(&printField, &deleteField, &compareFields);
     toReturn->families = initializeList(&printFamily, &deleteFamily, &compareFamilies);
 
-    toReturn->givenName = malloc(sizeof(char)*(strlen(firstname)+1));
+    toReturn->givenName = givenName;
     strcpy(toReturn->givenName,firstname);
-    toReturn->surname = malloc(sizeof(char)*(strlen(lastname)+1));
+    toReturn->surname = surname;
     strcpy(toReturn->surname,lastname);
 
-    addIndividual(gedcomObject, toReturn);
+    return toReturn;
+}
+
+int JSONaddindi(char* fileName, char* firstname, char* lastname){
+    //the record goes in front of the trailer, the rest of the file is left as it is
+    GEDCOMerror error = appendIndividual(fileName, firstname, lastname);
+
+    //the cached copy no longer matches the file, unless nothing was written to it
+    if(error.type == OK){
+        invalidateGEDCOM(fileName);
+    }
 
-    writeGEDCOM(fileName, gedcomObject);
+    return error.type;
 }
 
 char* filterfiles(char* fileName){
-    GEDCOMobject* gedcomObject = NULL;
-
     char* toReturn = calloc(50, sizeof(char));
-    createGEDCOM(fileName, &gedcomObject);
+    GEDCOMhandle* handle = acquireGEDCOM(fileName, NULL);
 
-    if(validateGEDCOM(gedcomObject) == OK){
+    if(handle != NULL && validateGEDCOM(getCachedGEDCOM(handle)) == OK){
         strcpy(toReturn, "OK");
     }
     else{
         strcpy(toReturn, "NOTOK");
     }
 
+    releaseGEDCOM(handle);
+
+    return toReturn;
+
+}
+
+
+char* statsToJSON(char* fileName){
+    char* toReturn = calloc(200, sizeof(char));
+
+    //cached files are loaded with LOAD_INTERN, so their string counts are kept
+    GEDCOMhandle* handle = acquireGEDCOM(fileName, NULL);
+    if(handle == NULL){
+        strcpy(toReturn, "{}");
+        return toReturn;
+    }
+
+    GEDCOMstats stats = getGEDCOMstats(getCachedGEDCOM(handle));
+    sprintf(toReturn, "{\"strings\":%d,\"unique\":%d,\"stringBytes\":%zu,\"savedBytes\":%zu,\"arenaBytes\":%zu}",
+        stats.strings, stats.uniqueStrings, stats.stringBytes, stats.savedBytes, stats.arenaBytes);
+    releaseGEDCOM(handle);
+
     return toReturn;
+}
 
+
+char* cacheStatsToJSON(void){
+    char* toReturn = calloc(200, sizeof(char));
+
+    GEDCOMcacheStats stats = getGEDCOMcacheStats();
+    sprintf(toReturn, "{\"hits\":%lu,\"misses\":%lu,\"evictions\":%lu,\"invalidations\":%lu,\"entries\":%d,\"bytes\":%zu,\"budget\":%zu}",
+        stats.hits, stats.misses, stats.evictions, stats.invalidations, stats.entries, stats.bytes, stats.budget);
+
+    return toReturn;
 }
 
 
 char* GEDCOMtoJSON(char* fileName){
-    GEDCOMobject* gedcomObject = NULL;
+    GEDCOMhandle* handle = acquireGEDCOM(fileName, NULL);
+    if(handle == NULL){
+        char* empty = malloc(sizeof(char) * 3);
+        strcpy(empty, "{}");
+        return empty;
+    }
+
+    char* toReturn = summaryToJSON(getCachedGEDCOM(handle));
+    releaseGEDCOM(handle);
+    return toReturn;
+}
 
-    char* toReturn = calloc(5000, sizeof(char));
-    createGEDCOM(fileName, &gedcomObject);
-    strcpy(toReturn, "{\"source\":\"\0");
-    strcat(toReturn,gedcomObject->header->source);
-    strcat(toReturn, "\",\"version\":\"");
+
+char* summaryToJSON(const GEDCOMobject* gedcomObject){
+    //the source and submitter name can be any length once CONT/CONC lines are joined
+    growString str = initializeString();
+    appendString(&str, "{\"source\":\"");
+    appendString(&str,gedcomObject->header->source);
+    appendString(&str, "\",\"version\":\"");
     char buffer[10];
     sprintf(buffer,"%.2f\",", gedcomObject->header->gedcVersion);
-    strcat(toReturn, buffer);
-    strcat(toReturn, "\"encoding\":\"");
+    appendString(&str, buffer);
+    appendString(&str, "\"encoding\":\"");
     if(gedcomObject->header->encoding == ANSEL){
-        strcat(toReturn, "ANSEL\",");
+        appendString(&str, "ANSEL\",");
     }
     else if(gedcomObject->header->encoding == UTF8){
-        strcat(toReturn, "UTF-8\",");
+        appendString(&str, "UTF-8\",");
     }
     else if(gedcomObject->header->encoding == UNICODE){
-        strcat(toReturn, "UNICODE\",");
+        appendString(&str, "UNICODE\",");
     }
     else if(gedcomObject->header->encoding == ASCII){
-        strcat(toReturn, "ASCII\",");
+        appendString(&str, "ASCII\",");
     } 
-    strcat(toReturn, "\"name\":\"");
-    strcat(toReturn,gedcomObject->submitter->submitterName);
-    strcat(toReturn, "\",\"adress\":\"");
+    appendString(&str, "\"name\":\"");
+    appendString(&str,gedcomObject->submitter->submitterName);
+    appendString(&str, "\",\"adress\":\"");
     if(strlen(gedcomObject->submitter->address) != 0){
-        strcat(toReturn,gedcomObject->submitter->address);
+        appendString(&str,gedcomObject->submitter->address);
     }
-    strcat(toReturn, "\",");
+    appendString(&str, "\",");
     char tempnumbers[200];
     sprintf(tempnumbers, "\"indi\":\"%d\",\"fam\":\"%d\"", gedcomObject->individuals.length, gedcomObject->families.length);
-    strcat(toReturn, tempnumbers);
-    strcat(toReturn, "}");
-    /*deleteGEDCOM(gedcomObject);*/
-    return toReturn;
+    appendString(&str, tempnumbers);
+    appendString(&str, "}");
+    return str.text;
     
 }
 
 
 char* createIndJSON(char* fileName){
-    GEDCOMobject* gedcomObject = NULL;
-    createGEDCOM(fileName, &gedcomObject);
+    GEDCOMhandle* handle = acquireGEDCOM(fileName, NULL);
+    if(handle == NULL){
+        char* empty = malloc(sizeof(char) * 3);
+        strcpy(empty, "[]");
+        return empty;
+    }
 
-    char *indList = iListToJSON(gedcomObject->individuals);
+    char *indList = iListToJSON(getCachedGEDCOM(handle)->individuals);
+    releaseGEDCOM(handle);
     return indList;
 }
 
@@ -1453,47 +1325,45 @@ void saveGEDCOM(char* fileName, char* submname, char* submadress){
 }
 
 char* JSONdescendants(char* filename, char* firstname, char* lastname, int num){
-    GEDCOMobject* gedcomObject = NULL;
+    GEDCOMhandle* handle = acquireGEDCOM(filename, NULL);
 
-    createGEDCOM(filename, &gedcomObject);
+    //the records are borrowed and serialized before the handle is released
+    char* temp = relativesToJSON(getCachedGEDCOM(handle), firstname, lastname, num, DESCENDANT_LINKS);
 
-    Individual* indi = malloc(sizeof(Individual));
+    releaseGEDCOM(handle);
 
-    indi->givenName = malloc(sizeof(char)*(strlen(firstname)+1));
-    sprintf(indi->givenName,"%s",firstname);
-    indi->surname = malloc(sizeof(char)*(strlen(lastname)+1));
-    sprintf(indi->surname,"%s",lastname);
+    return temp;
+}
 
-    List descendants = getDescendantListN(gedcomObject, indi, num);
+char* relativesToJSON(const GEDCOMobject* gedcomObject, const char* firstname, const char* lastname, int num, traverseDirection direction){
+    //the query starts from the record with these names, the first one if there are several
+    Individual name;
+    name.givenName = (char*)firstname;
+    name.surname = (char*)lastname;
+    Individual* indi = findPerson(gedcomObject, &findName, &name);
 
-    deleteGEDCOM(gedcomObject);
+    List generations;
+    if(direction == ANCESTOR_LINKS){
+        generations = getAncestorListNView(gedcomObject, indi, num);
+    }
+    else{
+        generations = getDescendantListNView(gedcomObject, indi, num);
+    }
 
-    char* temp = gListToJSON(descendants);
+    char* temp = gListToJSON(generations);
 
-    clearList(&descendants);
+    clearList(&generations);
 
     return temp;
 }
 
 char* JSONancestors(char* filename, char* firstname, char* lastname, int num){
-    GEDCOMobject* gedcomObject = NULL;
-
-    createGEDCOM(filename, &gedcomObject);
-
-    Individual* indi = malloc(sizeof(Individual));
+    GEDCOMhandle* handle = acquireGEDCOM(filename, NULL);
 
-    indi->givenName = malloc(sizeof(char)*(strlen(firstname)+1));
-    sprintf(indi->givenName,"%s",firstname);
-    indi->surname = malloc(sizeof(char)*(strlen(lastname)+1));
-    sprintf(indi->surname,"%s",lastname);
+    //the records are borrowed and serialized before the handle is released
+    char* temp = relativesToJSON(getCachedGEDCOM(handle), firstname, lastname, num, ANCESTOR_LINKS);
 
-    List descendants = getAncestorListN(gedcomObject, indi, num);
-
-    deleteGEDCOM(gedcomObject);
-
-    char* temp = gListToJSON(descendants);
-
-    clearList(&descendants);
+    releaseGEDCOM(handle);
 
     return temp;
 }
@@ -1620,31 +1490,26 @@ void addIndividual(GEDCOMobject* obj, const Individual* toBeAdded){
  *@param iList - a pointer to a list of Individual structs
  **/
 char* iListToJSON(List iList){
-    char* toReturn = malloc(sizeof(char)* 10000);
-
-    if(iList.length == 0){
-        strcpy(toReturn,"[]\0");
-    }
+    growString str = initializeString();
 
-    strcpy(toReturn,"[\0");
+    appendString(&str, "[");
 
     ListIterator iter = createIterator(iList);
     while(iter.current != NULL){
         char* temp = indToJSON(iter.current->data);
-        strcat(toReturn, temp);
+        appendString(&str, temp);
         free(temp);
 
         nextElement(&iter);
 
         if(iter.current != NULL){
-            strcat(toReturn, ",");
+            appendString(&str, ",");
         }
     }
 
+    appendString(&str, "]");
 
-    strcat(toReturn ,"]");
-
-    return toReturn;
+    return str.text;
 }
 
 /** Function for converting a list of lists of Individual structs into a JSON string
@@ -1654,40 +1519,33 @@ char* iListToJSON(List iList){
  *@param gList - a pointer to a list of lists of Individual structs
  **/
 char* gListToJSON(List gList){
+    growString str = initializeString();
 
-    char* toReturn = malloc(sizeof(char)* 10000);
-
-    if(gList.length == 0){
-        strcpy(toReturn,"[]\0");
-        return toReturn;
-    }
-
-    strcpy(toReturn,"[\0");
-
+    appendString(&str, "[");
 
     ListIterator iter = createIterator(gList);
     while(iter.current != NULL){
         char* temp = iListToJSON(*(List*)iter.current->data);
-        strcat(toReturn, temp);
+        appendString(&str, temp);
         free(temp);
 
         nextElement(&iter);
         
         if(iter.current != NULL){
-            strcat(toReturn, ",");
+            appendString(&str, ",");
         }
     }
 
-    strcat(toReturn ,"]");
-
-    return toReturn;
+    appendString(&str, "]");
 
+    return str.text;
 }
 
 
 //****************************************** List helper functions added for A2 *******************************************
 void deleteGeneration(void* toBeDeleted){
     clearList((List*)toBeDeleted);
+    free((List*)toBeDeleted);
 }
 
 int compareGenerations(const void* first,const void* second){
@@ -1724,7 +1582,8 @@ int compareEvents(const void* first,const void* second){
 }
 
 char* printEvent(void* toBePrinted){
-	char* toReturn = malloc(sizeof(char)*502);
+    char* temp = toString(((Event*)toBePrinted)->otherFields);
+	char* toReturn = malloc(sizeof(char) * (strlen(((Event*)toBePrinted)->date) + strlen(((Event*)toBePrinted)->place) + strlen(temp) + 60));
 	
 	strcpy(toReturn, "Event:\nType: ");
 	strcat(toReturn, ((Event*)toBePrinted)->type);
@@ -1733,7 +1592,6 @@ char* printEvent(void* toBePrinted){
 	strcat(toReturn, "\nPlace: ");
 	strcat(toReturn, ((Event*)toBePrinted)->place);
 	strcat(toReturn, "\nEvent Fields:\n");
-    char* temp = toString(((Event*)toBePrinted)->otherFields);
     strcat(toReturn, temp);
     free(temp);
 
@@ -1765,20 +1623,20 @@ int compareIndividuals(const void* first,const void* second){
 }
 
 char* printIndividual(void* toBePrinted){
-	char* toReturn = malloc(sizeof(char)*2002);
+    char* events = toString(((Individual*)toBePrinted)->events);
+    char* fields = toString(((Individual*)toBePrinted)->otherFields);
+	char* toReturn = malloc(sizeof(char) * (strlen(((Individual*)toBePrinted)->givenName) + strlen(((Individual*)toBePrinted)->surname) + strlen(events) + strlen(fields) + 60));
 	
 	strcpy(toReturn, "Individual:\nName: ");
 	strcat(toReturn, ((Individual*)toBePrinted)->givenName);
 	strcat(toReturn, (" "));
 	strcat(toReturn, ((Individual*)toBePrinted)->surname);
 	strcat(toReturn, "\n\nEvents:\n");
-    char* temp = toString(((Individual*)toBePrinted)->events);
-    strcat(toReturn, temp);
-    free(temp);
+    strcat(toReturn, events);
+    free(events);
     strcat(toReturn, "\nIndividual Fields:\n");
-    temp = toString(((Individual*)toBePrinted)->otherFields);
-    strcat(toReturn, temp);
-    free(temp);
+    strcat(toReturn, fields);
+    free(fields);
     strcat(toReturn, "\n");
 	
     return toReturn;
@@ -1823,36 +1681,35 @@ int compareFamilies(const void* first,const void* second){
 }
 
 char* printFamily(void* toBePrinted){
-	char* toReturn = malloc(sizeof(char)*2002);
-	strcpy(toReturn, "\n\nFamily:\nHusband:\n\0");
+	growString str = initializeString();
+	appendString(&str, "\n\nFamily:\nHusband:\n");
     char* temp;
     if(((Family*)toBePrinted)->husband != NULL){
         temp = printName(((Family*)toBePrinted)->husband);
-	    strcat(toReturn,temp);
+	    appendString(&str,temp);
         free(temp);
     }
-	strcat(toReturn, "\nWife:\n");
+	appendString(&str, "\nWife:\n");
     if(((Family*)toBePrinted)->wife != NULL){
         temp = printName(((Family*)toBePrinted)->wife);
-	    strcat(toReturn,temp);
+	    appendString(&str,temp);
         free(temp);
     }
-	strcat(toReturn, "\nChildren:\n");
+	appendString(&str, "\nChildren:\n");
     ListIterator iter = createIterator(((Family*)toBePrinted)->children);
     while(iter.current != NULL){
         temp = printName(iter.current->data);
-        strcat(toReturn, temp); 
+        appendString(&str, temp); 
         free(temp);
-        strcat(toReturn, "\n");
+        appendString(&str, "\n");
         nextElement(&iter);
     }
-	strcat(toReturn, "Family Fields:");
+	appendString(&str, "Family Fields:");
     temp = toString(((Family*)toBePrinted)->otherFields);
-    strcat(toReturn, temp);
+    appendString(&str, temp);
     free(temp);
-    strcat(toReturn, "\0");
 	
-    return toReturn;
+    return str.text;
 }
 
 void deleteField(void* toBeDeleted){
@@ -1862,23 +1719,21 @@ void deleteField(void* toBeDeleted){
 }
 
 int compareFields(const void* first,const void* second){
-    char firstCat[102] = "\0";
-    char secondCat[102] = "\0";
-
-    strcat(firstCat,((Field*)first)->tag);
-    strcat(firstCat," ");
-    strcat(firstCat,((Field*)first)->value);
+    Field* a = (Field*)first;
+    Field* b = (Field*)second;
 
-    strcat(secondCat,((Field*)second)->tag);
-    strcat(secondCat," ");
-    strcat(secondCat,((Field*)second)->value);
+    //pooled strings are equal exactly when they are the same pointer, so strcmp is only needed for the rest
+    int result = a->tag == b->tag ? 0 : strcmp(a->tag, b->tag);
+    if(result != 0){
+        return result;
+    }
 
-    return strcmp(firstCat,secondCat);
+    return a->value == b->value ? 0 : strcmp(a->value, b->value);
 }
 
 char* printField(void* toBePrinted){
 
-    char* toReturn = malloc(sizeof(char) * 255);
+    char* toReturn = malloc(sizeof(char) * (strlen(((Field*)toBePrinted)->tag) + strlen(((Field*)toBePrinted)->value) + 25));
     sprintf(toReturn, "Field:\nTag: %s\nValue: %s\n", ((Field*)toBePrinted)->tag , ((Field*)toBePrinted)->value);
 
     return toReturn;
@@ -1893,6 +1748,7 @@ Event* copyEvent(Event* toCopy){
     strcpy(event->date, toCopy->date);
     event->place = malloc(sizeof(char)* (strlen(toCopy->place) + 1));
     strcpy(event->place, toCopy->place);
+    event->otherFields = initializeList(&printField, &deleteField, &compareFields);
 
     ListIterator iter1 = createIterator(toCopy->otherFields);
     while(iter1.current != NULL){
@@ -1919,6 +1775,7 @@ Family* copyFamily(Family* toCopy){
     family->husband = toCopy->husband;
     family->wife = toCopy->wife;
     family->children = initializeList(&printIndividual, &dummyDelete, &compareIndividuals);
+    family->events = initializeList(&printEvent, &deleteEvent, &compareEvents);
     family->otherFields = initializeList(&printField, &deleteField, &compareFields);
     ListIterator iter = createIterator(toCopy->children);
     while(iter.current != NULL){
@@ -1930,6 +1787,11 @@ Family* copyFamily(Family* toCopy){
         insertBack(&family->otherFields, copyField((Field*)iter1.current->data));
         nextElement(&iter1);
     }
+    ListIterator iter2 = createIterator(toCopy->events);
+    while(iter2.current != NULL){
+        insertBack(&family->events, copyEvent((Event*)iter2.current->data));
+        nextElement(&iter2);
+    }
 
     return family;
 }
@@ -1988,341 +1850,39 @@ bool cmpEvent(Individual* a, const Individual* b){
     return true;
 }
 
-void createFamilies (GEDCOMobject* temp, char* fileName, List tempStore, GEDCOMerror* error){
-
-    char* token;
-    char line[256];
-    int lineNumb = 0;
+void createFamilies(parseState* state, GEDCOMerror* error){
 
-    FILE* inFile = fopen(fileName, "r");
-    customFgets(line, 256, inFile, error);
-    lineNumb++;
-    contconcCheck(line, inFile, &lineNumb, error);
+    //link every family reference recorded during the parse to its individual
+    ListIterator iter = createIterator(state->pendingRefs);
+    while(iter.current != NULL){
+        pendingRef* ref = (pendingRef*)iter.current->data;
+        tagIndi* found = (tagIndi*)lookupTable(state->xrefTable, ref->tag);
 
-    while(!feof(inFile)){
-        if(strncmp(line,"0 TRLR", 6) == 0){
-            break;
+        //if individual not found means invalid line
+        if(found == NULL || found->temp == NULL){
+            error->type = INV_RECORD;
+            error->line = ref->line;
+            return;
         }
-        //go thru file and filter families
-        token = tokenize(line);
-        if(token == NULL){
-            customFgets(line, 256, inFile, error);
-            lineNumb++;
-            if(error->type != OK){
-                error->type = INV_RECORD;
-                error->line = lineNumb;
-                fclose(inFile);
-                return;
-            }
-            contconcCheck(line, inFile, &lineNumb, error);
-            continue;
+
+        Individual* indi = found->temp;
+        if(ref->type == HUSB_REF){
+            ref->fam->husband = indi;
         }
-        if(strncmp(token,"FAM", 3) != 0){
-            customFgets(line, 256, inFile, error);
-            lineNumb++;
-            if(error->type != OK){
-                error->type = INV_RECORD;
-                error->line = lineNumb;
-                fclose(inFile);
-                return;
-            }
-            contconcCheck(line, inFile, &lineNumb, error);
-            continue;
+        else if(ref->type == WIFE_REF){
+            ref->fam->wife = indi;
         }
-        if(strncmp(token,"FAM", 3) == 0){
-            Family* fam = malloc(sizeof(Family));
-            fam->children = initializeList(&printIndividual, &dummyDelete, &compareIndividuals);
-            fam->events = initializeList(&printEvent, &deleteEvent, &compareEvents);
-            fam->otherFields = initializeList(&printField, &deleteField, &compareFields);
-            customFgets(line, 256, inFile, error);
-            lineNumb++;
-            contconcCheck(line, inFile, &lineNumb, error);
-            while(line[0] != '0'){
-                //check if wife reference
-                if(strncmp("1 WIFE",line,6) == 0){
-                    token = tokenize(line);
-                    if(token == NULL){
-                        error->type = INV_RECORD;
-                        error->line = lineNumb;
-                        deleteFamily(fam);
-                        fclose(inFile);
-                        return;
-                    }
-                    void *tempWife = findElement(tempStore, &compareTag, token);
-                    //if wife not found means invalid line
-                    if(tempWife == NULL){
-                        error->type = INV_RECORD;
-                        error->line = lineNumb;
-                        deleteFamily(fam);
-                        fclose(inFile);
-                        return;
-                    }
-                    Individual* wife = ((tagIndi*)tempWife)->temp;
-                    //if wife not found means invalid line
-                    if(wife == NULL){
-                        error->type = INV_RECORD;
-                        error->line = lineNumb;
-                        deleteFamily(fam);
-                        fclose(inFile);
-                        return;
-                    }
-                    //otherwise create reference to wife
-                    fam->wife = (Individual*)wife;
-                    insertBack(&wife->families, fam);
-                }
-                //check if husband reference
-                else if(strncmp("1 HUSB",line,6) == 0){
-                    token = tokenize(line);
-                    if(token == NULL){
-                        error->type = INV_RECORD;
-                        error->line = lineNumb;
-                        deleteFamily(fam);
-                        fclose(inFile);
-                        return;
-                    }
-                    void *tempHusb = findElement(tempStore, &compareTag, token);
-                    //if husband not found means invalid line
-                    if(tempHusb == NULL){
-                        error->type = INV_RECORD;
-                        error->line = lineNumb;
-                        deleteFamily(fam);
-                        fclose(inFile);
-                        return;
-                    }
-                    Individual* husband = ((tagIndi*)tempHusb)->temp;
-                    //otherwise create reference to husband
-                    fam->husband = (Individual*)husband;
-                    insertBack(&husband->families, fam);
-                }
-                //check for a child reference
-                else if(strncmp("1 CHIL",line,6) == 0){
-                    token = tokenize(line);
-                    if(token == NULL){
-                        error->type = INV_RECORD;
-                        error->line = lineNumb;
-                        deleteFamily(fam);
-                        fclose(inFile);
-                        return;
-                    }
-                    void *tempChild = findElement(tempStore, &compareTag, token);
-                    //if child not found return error
-                    if(tempChild == NULL){
-                        error->type = INV_RECORD;
-                        error->line = lineNumb;
-                        fclose(inFile);
-                        deleteFamily(fam);
-                        return;
-                    }
-                    Individual* child = ((tagIndi*)tempChild)->temp;
-                    //otherwise create references to children
-                    insertBack(&fam->children,child);
-                    insertBack(&child->families, fam);
-                }
-                else if(strncmp(line,"1 EVEN", 6) == 0 || strncmp(line,"1 MARS",6) == 0 || strncmp(line,"1 MARL",6) == 0 || strncmp(line,"1 MARC",6) == 0 ||
-                        strncmp(line,"1 MARB",6) == 0 || strncmp(line,"1 MARR",6) == 0  || strncmp(line,"1 ENGA",6) == 0  || strncmp(line,"1 DIVF",6) == 0  
-                        || strncmp(line,"1 DIV",5) == 0 || strncmp(line,"1 CENS",6) == 0 || strncmp(line,"1 ANUL",6) == 0){
-
-                        Event* event = malloc(sizeof(Event));
-                        event->otherFields = initializeList(&printField, &deleteField, &compareFields);
-                        strncpy(event->type, token, 4);
-                        while(1){
-                            customFgets(line, 256, inFile, error);
-                            lineNumb++;
-                            if(error->type != OK){
-                                error->type = INV_RECORD;
-                                error->line = lineNumb;
-                                return;
-                            }
-                            contconcCheck(line, inFile, &lineNumb, error);
-                            //if event record over break loop
-                            if(line[0] == '0' || line[0] == '1'){
-                                if(event->date == NULL){
-                                    event->date = malloc(sizeof(char));
-                                    strcpy(event->date,"");
-                                }
-                                if(event->place == NULL){
-                                    event->place = malloc(sizeof(char));
-                                    strcpy(event->place,"");
-                                }
-                                break;
-                            }
-                            //retrieve event date
-                            if(strncmp(line,"2 DATE",6) == 0){
-                                token = tokenize(line);
-                                if(token == NULL){
-                                    error->line = lineNumb;
-                                    error->type = INV_RECORD;
-                                    return;
-                                }
-                                event->date = malloc(sizeof(char)* (strlen(token) + 1));
-                                sprintf(event->date, "%s", token);
-                            }
-                            //retrieve event place
-                            else if(strncmp(line,"2 PLAC",6) == 0){
-                                token = tokenize(line);
-                                if(token == NULL){
-                                    error->line = lineNumb;
-                                    error->type = INV_RECORD;
-                                    return;
-                                }
-                                event->place = malloc(sizeof(char)* (strlen(token) + 1));
-                                sprintf(event->place, "%s", token);
-                            }
-                            else{
-                                //create appropariate event field if valid
-                                Field* field = malloc(sizeof(Field));
-                                token = strtok(line, " ");
-                                token = strtok(NULL, " ");
-                                if(token == NULL){
-                                    error->line = lineNumb;
-                                    error->type = INV_RECORD;
-                                    continue;
-                                }
-                                field->tag = malloc(sizeof(char)* (strlen(token) + 1));
-                                sprintf(field->tag, "%s", token);
-                                token = strtok(NULL, "");
-                                if(token == NULL){
-                                    error->line = lineNumb;
-                                    error->type = INV_RECORD;
-                                    continue;
-                                }
-                                field->value = malloc(sizeof(char)* (strlen(token) + 1));
-                                sprintf(field->value, "%s", token);
-                                insertBack(&event->otherFields,field);
-                            }
-                        }
-
-                        insertBack(&fam->events, event);
-                        continue;
-                }
-                else{
-                    //insert field into family lists if a valid field
-                    Field* field = malloc(sizeof(Field));
-                    token = strtok(line, " ");
-                    token = strtok(NULL, " ");
-                    if(token == NULL){
-                        free(field);
-                        customFgets(line, 256, inFile, error);
-                        lineNumb++;
-                        contconcCheck(line, inFile, &lineNumb, error);
-                        continue;
-                    }
-                    field->tag = malloc(sizeof(char)* (strlen(token) + 1));
-                    sprintf(field->tag, "%s", token);
-                    token = strtok(NULL, "");
-                    if(token == NULL){
-                        free(field->tag);
-                        free(field);
-                        customFgets(line, 256, inFile, error);
-                        lineNumb++;
-                        contconcCheck(line, inFile, &lineNumb, error);
-                        continue;
-                    }
-                    field->value = malloc(sizeof(char)* (strlen(token) + 1));
-                    sprintf(field->value, "%s", token);
-                    insertBack(&fam->otherFields,field);
-                }
-                customFgets(line, 256, inFile, error);
-                lineNumb++;
-                if(error->type != OK){
-                    error->type = INV_RECORD;
-                    error->line = lineNumb;
-                    deleteFamily(fam);
-                    fclose(inFile);
-                    return;
-                }
-                contconcCheck(line, inFile, &lineNumb, error);
-            }
-            insertBack(&temp->families, fam);
+        else{
+            parseInsert(state, &ref->fam->children, indi);
         }
-    }
-    //if parsed families successfully return OK
-    fclose(inFile);
-    error->type = OK;
-}
-
-
-void contconcCheck(char* line, FILE* inFile, int* lineNumb, GEDCOMerror* error){
-    char temp[256];
-    char temp2[256];
-    char* token;
-
-    error->type = OK;
-
-    if(feof(inFile)){
-        return;
-    }
-
-    customFgets(temp, 256, inFile, error);
-    *lineNumb = *lineNumb + 1;
-    strcpy(temp2, temp);
-
-    strtok(temp2, " ");
-    token = strtok(NULL, " ");
-    
-    if(token == NULL){
-        fseek(inFile, -strlen(temp)-1, SEEK_CUR);
-        *lineNumb = *lineNumb - 1;
-        return;
-    }
+        parseInsert(state, &indi->families, ref->fam);
 
-    //check if line continued on next line
-    if(strncmp(token, "CONT", 4) == 0){
-        token = strtok(NULL, "\0");
-        strcat(line, "\n");
-        strcat(line, token);
-        contconcCheck(line, inFile, lineNumb, error);
-    }
-    //check if line concated on next line
-    else if(strncmp(token, "CONC", 4) == 0){
-        token = strtok(NULL, "\0");
-        strcat(line, token);
-        contconcCheck(line, inFile, lineNumb, error);
-    }
-    //otherwise seek back and perform operations
-    else{
-        fseek(inFile, -strlen(temp)-1, SEEK_CUR);
-        *lineNumb = *lineNumb - 1;
+        nextElement(&iter);
     }
 
+    error->type = OK;
 }
 
-bool customFgets(char* line, int len, FILE* inFile, GEDCOMerror* error){
-    memset(line, 0, len);
-    size_t cur_len = strlen(line);
-    char chr;
-
-    while(1){
-    if(feof(inFile)){
-        error->type = OTHER_ERROR;
-        return false;
-    }
-    chr = fgetc(inFile);
-    cur_len = strlen(line);
-    //check for valid line terminators
-    if(chr == '\r' || chr == '\n'){
-        if(strlen(line)==0){
-            customFgets(line, 256, inFile, error);
-        }
-        chr = '\0';
-        sprintf(line, "%s%c", line, chr);
-        error->type = OK;
-        return true;
-    }
-    //check if line is appropriate length
-    else if(cur_len == len-1) {
-        error->type = OTHER_ERROR;
-        return false;
-    }
-        sprintf(line, "%s%c", line, chr);
-        if(feof(inFile) && strncmp(line, "0 TRLR", 6) == 0){
-            strcpy(line, "0 TRLR\0");
-            error->type = OK;
-            return true;
-        }
-    } 
-
-}
 
 bool compareTag(const void* a,const void* b) {
     //compare two individual tags for equality
@@ -2346,124 +1906,650 @@ char* tokenize (char line[]){
     return token;
 }
 
-Submitter* createSubmitter(char* fileName, GEDCOMerror* error, char* subtag){
-    FILE* inFile = fopen(fileName, "r");
-    char* token;
-    char* tag;
-    char line[256];
-    int lineNumb = 0;
-
-    while (1){
-        customFgets(line, 256, inFile, error);
-        //look thru file for submitter tag
-        if(strncmp(line,"0 TRLR", 6) == 0){
-            error->type = INV_GEDCOM;
-            error->line = -1;
-            fclose(inFile);
-            return NULL;
-        }
-        lineNumb++;
-        token = strtok(line, " ");
-        tag = strtok(NULL, " ");
-        token = strtok(NULL, "");
+bool readGEDCOMline(GEDCOMreader* reader, GEDCOMline* parts, int* lineNumb, GEDCOMerror* error){
+    size_t length;
+    const char* text = readFoldedLine(reader, &length);
 
-        if(token == NULL){
-            continue;
-        }
+    *lineNumb = text == NULL ? reader->lineNumb : reader->foldNumb;
+    if(text == NULL){
+        error->type = OTHER_ERROR;
+        return false;
+    }
 
-        if(strcmp(subtag, tag) == 0 && strncmp(token, "SUBM", 4) == 0){
-            break;
-        }
-        if(feof(inFile)){
-            error->type = INV_RECORD;
-            error->line = lineNumb;
-            fclose(inFile);
-            return NULL;
-        }
+    //check if line is appropriate length, the type tells it apart from the end of the file
+    if(reader->firstLength > 255){
+        error->type = INV_RECORD;
+        return false;
     }
 
-    //if submitter tag found create submitter
-    Submitter* a = malloc(sizeof(Submitter) + sizeof(char) * 255);
-    strcpy(a->address, "\0");
-    a->otherFields = initializeList(&printField, &deleteField, &compareFields);
+    //a line without a level or tag is left with a NULL tag for the caller to report
+    error->type = OK;
+    if(!splitLine(text, length, parts)){
+        parts->tag.start = NULL;
+    }
 
-    while(1){
-        // go thru submitter record and get fields
-        customFgets(line, 256, inFile, error);
-        lineNumb++;
-        if(error->type != OK){
-            fclose(inFile);
-            clearList(&a->otherFields);
-            free(a);
-            error->type = INV_GEDCOM;
-            error->line = -1;
-            return NULL;
+    return true;
+}
+
+bool splitLine(const char* line, size_t length, GEDCOMline* parts){
+    const char* cur = line;
+    const char* last = line + length;
+
+    parts->level = -1;
+    parts->xref.start = NULL;
+    parts->xref.length = 0;
+    parts->tag.start = NULL;
+    parts->tag.length = 0;
+    parts->value.start = NULL;
+    parts->value.length = 0;
+
+    //level number must come first
+    if(cur == last || *cur < '0' || *cur > '9'){
+        return false;
+    }
+    parts->level = 0;
+    while(cur < last && *cur >= '0' && *cur <= '9'){
+        parts->level = parts->level * 10 + (*cur - '0');
+        cur++;
+    }
+    while(cur < last && *cur == ' '){
+        cur++;
+    }
+
+    //optional cross reference pointer
+    if(cur < last && *cur == '@'){
+        parts->xref.start = cur;
+        while(cur < last && *cur != ' '){
+            cur++;
         }
-        contconcCheck(line, inFile, &lineNumb, error);
-        if(line[0] == '0'){
-            break;
+        parts->xref.length = cur - parts->xref.start;
+        while(cur < last && *cur == ' '){
+            cur++;
         }
-        //check if submitter name line
-        if (strncmp(line,"1 NAME",6) == 0)
-        {
-            token = tokenize(line);
-            if(token == NULL){
-                fclose(inFile);
-                clearList(&a->otherFields);
-                free(a);
-                error->type = INV_RECORD;
-                error->line = lineNumb;
-                return NULL;
-            }
-            sprintf(a->submitterName, "%s", token);
-        }
-        //check if submitter adress record
-        else if(strncmp(line,"1 ADDR",6) == 0){
-            token = tokenize(line);
-            if(token == NULL){
-                fclose(inFile);
-                clearList(&a->otherFields);
-                free(a);
+    }
+
+    //tag is required
+    if(cur == last){
+        return false;
+    }
+    parts->tag.start = cur;
+    while(cur < last && *cur != ' '){
+        cur++;
+    }
+    parts->tag.length = cur - parts->tag.start;
+
+    //anything left over is the line value
+    while(cur < last && *cur == ' '){
+        cur++;
+    }
+    if(cur < last){
+        parts->value.start = cur;
+        parts->value.length = last - cur;
+    }
+
+    return true;
+}
+
+int largestIndividualNumber(char* fileName){
+    GEDCOMreader* reader = createReader(fileName);
+    if(reader == NULL){
+        return -2;
+    }
+
+    int largest = -1;
+    const char* line;
+    size_t length;
+    while((line = readLine(reader, &length)) != NULL){
+        //only record lines of the form "0 @I<digits>@ ..." can clash with a new record
+        if(length < 6 || memcmp(line, "0 @I", 4) != 0){
+            continue;
+        }
+
+        size_t i = 4;
+        int number = 0;
+        while(i < length && i < 13 && line[i] >= '0' && line[i] <= '9'){
+            number = number * 10 + (line[i] - '0');
+            i++;
+        }
+        if(i > 4 && i < length && line[i] == '@' && number > largest){
+            largest = number;
+        }
+    }
+
+    deleteReader(reader);
+
+    return largest;
+}
+
+long findTrailer(const char* tail, size_t length, const char** eol){
+    //only line terminators and blanks may follow the trailer
+    size_t end = length;
+    while(end > 0 && strchr("\r\n \t", tail[end - 1]) != NULL){
+        end--;
+    }
+    if(end < 6 || memcmp(tail + end - 6, "0 TRLR", 6) != 0){
+        return -1;
+    }
+
+    size_t start = end - 6;
+    if(start > 0 && tail[start - 1] != '\n' && tail[start - 1] != '\r'){
+        return -1;
+    }
+
+    //use the terminator after the trailer, or failing that the one before it
+    const char* after = tail + end;
+    if(end < length){
+        if(after[0] == '\r' && end + 1 < length && after[1] == '\n'){
+            *eol = "\r\n";
+        }
+        else if(after[0] == '\n' && end + 1 < length && after[1] == '\r'){
+            *eol = "\n\r";
+        }
+        else if(after[0] == '\r'){
+            *eol = "\r";
+        }
+        else if(after[0] == '\n'){
+            *eol = "\n";
+        }
+    }
+    else if(start > 0){
+        if(tail[start - 1] == '\n'){
+            *eol = (start > 1 && tail[start - 2] == '\r') ? "\r\n" : "\n";
+        }
+        else{
+            *eol = (start > 1 && tail[start - 2] == '\n') ? "\n\r" : "\r";
+        }
+    }
+
+    return (long)start;
+}
+
+bool spanEquals(GEDCOMspan span, const char* str){
+    size_t length = strlen(str);
+
+    return span.start != NULL && span.length == length && memcmp(span.start, str, length) == 0;
+}
+
+bool spanPrefix(GEDCOMspan span, const char* str){
+    size_t length = strlen(str);
+
+    return span.start != NULL && span.length >= length && memcmp(span.start, str, length) == 0;
+}
+
+char* spanToString(GEDCOMspan span){
+    char* str = malloc(sizeof(char) * (span.length + 1));
+    if(span.length > 0){
+        memcpy(str, span.start, span.length);
+    }
+    str[span.length] = '\0';
+
+    return str;
+}
+
+void spanCopy(char* dest, size_t size, GEDCOMspan span){
+    size_t length = span.length < size - 1 ? span.length : size - 1;
+
+    if(length > 0){
+        memcpy(dest, span.start, length);
+    }
+    dest[length] = '\0';
+}
+
+unsigned long hashSpan(const void* key){
+    //FNV-1a, the same as hashString
+    const GEDCOMspan* span = (const GEDCOMspan*)key;
+    unsigned long hash = 2166136261UL;
+
+    for(size_t i = 0; i < span->length; i++){
+        hash ^= (unsigned char)span->start[i];
+        hash *= 16777619UL;
+    }
+
+    return hash;
+}
+
+bool compareSpans(const void* first,const void* second){
+    const GEDCOMspan* a = (const GEDCOMspan*)first;
+    const GEDCOMspan* b = (const GEDCOMspan*)second;
+
+    return a->length == b->length && (a->length == 0 || memcmp(a->start, b->start, a->length) == 0);
+}
+
+GEDCOMspan nextToken(GEDCOMspan* rest, const char* delims){
+    GEDCOMspan token;
+    const char* cur = rest->start;
+    const char* last = rest->start + rest->length;
+
+    //skip leading delimiters like strtok does
+    while(cur < last && strchr(delims, *cur) != NULL){
+        cur++;
+    }
+    token.start = cur;
+    while(cur < last && strchr(delims, *cur) == NULL){
+        cur++;
+    }
+    token.length = cur - token.start;
+    if(token.length == 0){
+        token.start = NULL;
+    }
+
+    rest->start = cur;
+    rest->length = last - cur;
+
+    return token;
+}
+
+growString initializeString(void){
+    growString str;
+    str.size = 256;
+    str.length = 0;
+    str.text = malloc(sizeof(char) * str.size);
+    str.text[0] = '\0';
+
+    return str;
+}
+
+void appendString(growString* str, const char* toAppend){
+    size_t length = strlen(toAppend);
+
+    if(str->length + length + 1 > str->size){
+        while(str->length + length + 1 > str->size){
+            str->size *= 2;
+        }
+        str->text = realloc(str->text, sizeof(char) * str->size);
+    }
+    memcpy(str->text + str->length, toAppend, length + 1);
+    str->length += length;
+}
+
+void initializeParseState(parseState* state, int flags){
+    GEDCOMobject* temp;
+
+    //an arena loaded object lives in its own arena, next to it
+    if(flags & (LOAD_ARENA | LOAD_INTERN | LOAD_GRAPH | LOAD_PARALLEL)){
+        Arena arena = initializeArena();
+        arenaObject* owner = arenaAlloc(&arena, sizeof(arenaObject));
+        owner->arena = arena;
+        memset(&owner->strings, 0, sizeof(HashTable));
+        memset(&owner->stats, 0, sizeof(GEDCOMstats));
+        owner->graph = NULL;
+        if(flags & LOAD_INTERN){
+            owner->strings = initializeTable(0, &hashSpan, &compareSpans, &arenaDelete);
+        }
+        temp = &owner->obj;
+        state->arena = &owner->arena;
+        state->pool = owner;
+    }
+    else{
+        temp = malloc(sizeof(GEDCOMobject));
+        state->arena = NULL;
+        state->pool = NULL;
+    }
+    state->obj = temp;
+
+    Header* header = parseAlloc(state, sizeof(Header));
+    strcpy(header->source, "");
+    header->gedcVersion = 0;
+    header->encoding = ANSEL;
+    header->submitter = NULL;
+    header->otherFields = parseList(state, &printField, &deleteField, &compareFields);
+
+    temp->header = header;
+    temp->submitter = NULL;
+    temp->individuals = parseList(state, &printIndividual, &deleteIndividual, &compareIndividuals);
+    temp->families = parseList(state, &printFamily, &deleteFamily, &compareFamilies);
+
+    state->xrefTable = initializeTable(0, &hashString, &compareStrings, &destroyNodeData);
+    state->pendingRefs = initializeList(&printIndividual, &destroyNodeData, &compareIndividuals);
+    strcpy(state->submTag, "");
+    state->charCheck = false;
+    state->inGedc = false;
+    state->record = HEAD_RECORD;
+    state->indi = NULL;
+    state->fam = NULL;
+    state->event = NULL;
+}
+
+void arenaDelete(void* data){
+}
+
+void* parseAlloc(parseState* state, size_t size){
+    if(state->arena != NULL){
+        return arenaAlloc(state->arena, size);
+    }
+
+    return malloc(size);
+}
+
+char* parseString(parseState* state, GEDCOMspan span){
+    if(state->arena != NULL){
+        return arenaString(state->arena, span.start, span.length);
+    }
+
+    return spanToString(span);
+}
+
+char* parseIntern(parseState* state, GEDCOMspan span){
+    if(state->pool == NULL || state->pool->strings.entries == NULL){
+        return parseString(state, span);
+    }
+
+    GEDCOMstats* stats = &state->pool->stats;
+    stats->strings++;
+
+    //the key of a pooled string is a span of the pooled copy
+    GEDCOMspan* found = lookupTable(state->pool->strings, &span);
+    if(found != NULL){
+        stats->savedBytes += span.length + 1;
+        return (char*)found->start;
+    }
+
+    GEDCOMspan* key = arenaAlloc(state->arena, sizeof(GEDCOMspan));
+    key->start = arenaString(state->arena, span.start, span.length);
+    key->length = span.length;
+    insertTable(&state->pool->strings, key, key);
+    stats->uniqueStrings++;
+    stats->stringBytes += span.length + 1;
+
+    return (char*)key->start;
+}
+
+void parseFree(parseState* state, void* data){
+    if(state->arena == NULL){
+        free(data);
+    }
+}
+
+void parseInsert(parseState* state, List* list, void* data){
+    if(state->arena == NULL){
+        insertBack(list, data);
+        return;
+    }
+
+    Node* node = arenaAlloc(state->arena, sizeof(Node));
+    node->data = data;
+    insertNodeBack(list, node);
+}
+
+List parseList(parseState* state, char* (*printFunction)(void* toBePrinted), void (*deleteFunction)(void* toBeDeleted), int (*compareFunction)(const void* first,const void* second)){
+    return initializeList(printFunction, state->arena != NULL ? &arenaDelete : deleteFunction, compareFunction);
+}
+
+bool validateParsedHeader(parseState* state){
+    Header* header = state->obj->header;
+
+    //validate header fields
+    if(strlen(header->source) == 0 || header->gedcVersion == 0 || !state->charCheck || strlen(state->submTag) == 0){
+        return false;
+    }
+
+    return true;
+}
+
+Field* createField(parseState* state, GEDCOMspan tag, GEDCOMspan value){
+    Field* field = parseAlloc(state, sizeof(Field));
+    field->tag = parseIntern(state, tag);
+    field->value = parseString(state, value);
+
+    return field;
+}
+
+void startRecord(parseState* state, const GEDCOMline* parts, int lineNumb, GEDCOMerror* error){
+    state->record = NO_RECORD;
+    state->indi = NULL;
+    state->fam = NULL;
+    state->event = NULL;
+
+    if(spanEquals(parts->tag, "INDI")){
+        GEDCOMspan empty = {NULL, 0};
+        Individual* indi = parseAlloc(state, sizeof(Individual));
+        indi->givenName = parseString(state, empty);
+        indi->surname = parseIntern(state, empty);
+        indi->events = parseList(state, &printEvent, &deleteEvent, &compareEvents);
+        indi->otherFields = parseList(state, &printField, &deleteField, &compareFields);
+        indi->families = parseList(state, &printFamily, &dummyDelete, &compareFamilies);
+        parseInsert(state, &state->obj->individuals, indi);
+
+        //remember the individual so family references can find it later
+        tagIndi* tempindi = malloc(sizeof(tagIndi));
+        spanCopy(tempindi->tag, sizeof(tempindi->tag), parts->xref);
+        tempindi->temp = indi;
+        //the first individual with a given tag is the one references resolve to
+        if(!insertTable(&state->xrefTable, tempindi->tag, tempindi)){
+            free(tempindi);
+        }
+
+        state->indi = indi;
+        state->record = INDI_RECORD;
+    }
+    else if(spanEquals(parts->tag, "FAM")){
+        Family* fam = parseAlloc(state, sizeof(Family));
+        fam->wife = NULL;
+        fam->husband = NULL;
+        fam->children = parseList(state, &printIndividual, &dummyDelete, &compareIndividuals);
+        fam->events = parseList(state, &printEvent, &deleteEvent, &compareEvents);
+        fam->otherFields = parseList(state, &printField, &deleteField, &compareFields);
+        parseInsert(state, &state->obj->families, fam);
+
+        state->fam = fam;
+        state->record = FAM_RECORD;
+    }
+    else if(spanEquals(parts->tag, "SUBM")){
+        //only the submitter referenced by the header is kept
+        if(!spanEquals(parts->xref, state->submTag) || state->obj->submitter != NULL){
+            return;
+        }
+        Submitter* submitter = parseAlloc(state, sizeof(Submitter) + sizeof(char) * 255);
+        strcpy(submitter->submitterName, "");
+        strcpy(submitter->address, "");
+        submitter->otherFields = parseList(state, &printField, &deleteField, &compareFields);
+        state->obj->submitter = submitter;
+        state->record = SUBM_RECORD;
+    }
+}
+
+void parseHeaderLine(parseState* state, const GEDCOMline* parts, int lineNumb, GEDCOMerror* error){
+    Header* header = state->obj->header;
+    bool inGedc = state->inGedc;
+
+    state->inGedc = false;
+
+    //get GECOM file source
+    if(parts->level == 1 && spanEquals(parts->tag, "SOUR")){
+        if(parts->value.start == NULL){
+            error->type = INV_HEADER;
+            error->line = lineNumb;
+            return;
+        }
+        spanCopy(header->source, sizeof(header->source), parts->value);
+    }
+    //parse GEDCOM version
+    else if(parts->level == 1 && spanEquals(parts->tag, "GEDC")){
+        state->inGedc = true;
+    }
+    else if(inGedc && parts->level == 2 && spanEquals(parts->tag, "VERS")){
+        if(parts->value.start == NULL){
+            error->type = INV_HEADER;
+            error->line = lineNumb;
+            return;
+        }
+        char version[32];
+        spanCopy(version, sizeof(version), parts->value);
+        header->gedcVersion = atof(version);
+    }
+    //parse char type of GEDCOM document
+    else if(parts->level == 1 && spanEquals(parts->tag, "CHAR")){
+        state->charCheck = true;
+        if(spanPrefix(parts->value, "ANSEL")){
+            header->encoding = ANSEL;
+        }
+        else if(spanPrefix(parts->value, "UTF-8")){
+            header->encoding = UTF8;
+        }
+        else if(spanPrefix(parts->value, "UNICODE")){
+            header->encoding = UNICODE;
+        }
+        else if(spanPrefix(parts->value, "ASCII")){
+            header->encoding = ASCII;
+        }
+        else{
+            error->type = INV_HEADER;
+            error->line = lineNumb;
+            return;
+        }
+    }
+    //check if submitter present
+    else if(parts->level == 1 && spanEquals(parts->tag, "SUBM")){
+        if(parts->value.start == NULL){
+            error->type = INV_HEADER;
+            error->line = lineNumb;
+            return;
+        }
+        spanCopy(state->submTag, sizeof(state->submTag), parts->value);
+    }
+    else{
+        //insert header field if correct field
+        if(parts->value.start == NULL){
+            error->type = INV_HEADER;
+            error->line = lineNumb;
+            return;
+        }
+        parseInsert(state, &header->otherFields, createField(state, parts->tag, parts->value));
+    }
+}
+
+void parseSubmitterLine(parseState* state, const GEDCOMline* parts, int lineNumb, GEDCOMerror* error){
+    Submitter* submitter = state->obj->submitter;
+
+    //every submitter line needs a value
+    if(parts->value.start == NULL){
+        error->type = INV_RECORD;
+        error->line = lineNumb;
+        return;
+    }
+
+    //check if submitter name line
+    if(parts->level == 1 && spanEquals(parts->tag, "NAME")){
+        spanCopy(submitter->submitterName, sizeof(submitter->submitterName), parts->value);
+    }
+    //check if submitter adress record
+    else if(parts->level == 1 && spanEquals(parts->tag, "ADDR")){
+        spanCopy(submitter->address, 255, parts->value);
+    }
+    //otherwise add as a submitter field
+    else{
+        parseInsert(state, &submitter->otherFields, createField(state, parts->tag, parts->value));
+    }
+}
+
+void parseIndividualLine(parseState* state, const GEDCOMline* parts, int lineNumb, GEDCOMerror* error){
+    Individual* indi = state->indi;
+
+    //only the name of an individual is kept for now
+    if(parts->level != 1 || !spanEquals(parts->tag, "NAME")){
+        return;
+    }
+
+    //given name is the first word, surname the second, slashes are dropped
+    GEDCOMspan rest = parts->value;
+    GEDCOMspan given = nextToken(&rest, " /");
+    GEDCOMspan surname = nextToken(&rest, " /");
+
+    parseFree(state, indi->givenName);
+    indi->givenName = parseString(state, given);
+    parseFree(state, indi->surname);
+    indi->surname = parseIntern(state, surname);
+}
+
+void parseFamilyLine(parseState* state, const GEDCOMline* parts, int lineNumb, GEDCOMerror* error){
+    Family* fam = state->fam;
+
+    if(parts->level == 1){
+        state->event = NULL;
+
+        //husband, wife and children are recorded and linked after the trailer
+        int refType = -1;
+        if(spanEquals(parts->tag, "HUSB")){
+            refType = HUSB_REF;
+        }
+        else if(spanEquals(parts->tag, "WIFE")){
+            refType = WIFE_REF;
+        }
+        else if(spanEquals(parts->tag, "CHIL")){
+            refType = CHIL_REF;
+        }
+
+        if(refType != -1){
+            if(parts->value.start == NULL){
                 error->type = INV_RECORD;
                 error->line = lineNumb;
-                return NULL;
+                return;
             }
-            sprintf(a->address, "%s", token);
+            pendingRef* ref = malloc(sizeof(pendingRef));
+            spanCopy(ref->tag, sizeof(ref->tag), parts->value);
+            ref->type = refType;
+            ref->fam = fam;
+            ref->line = lineNumb;
+            insertBack(&state->pendingRefs, ref);
         }
-        //otherwise check if valid submitter field
-        else{
-            Field* field = malloc(sizeof(Field));
-            token = strtok(line, " ");
-            token = strtok(NULL, " ");
-            if(token == NULL){
-                fclose(inFile);
-                clearList(&a->otherFields);
-                free(a);
+        else if(isFamilyEvent(parts->tag)){
+            GEDCOMspan empty = {NULL, 0};
+            Event* event = parseAlloc(state, sizeof(Event));
+            spanCopy(event->type, sizeof(event->type), parts->tag);
+            event->date = parseString(state, empty);
+            event->place = parseIntern(state, empty);
+            event->otherFields = parseList(state, &printField, &deleteField, &compareFields);
+            parseInsert(state, &fam->events, event);
+            state->event = event;
+        }
+        //insert field into family lists if a valid field
+        else if(parts->value.start != NULL){
+            parseInsert(state, &fam->otherFields, createField(state, parts->tag, parts->value));
+        }
+    }
+    else if(state->event != NULL){
+        Event* event = state->event;
+
+        //retrieve event date
+        if(parts->level == 2 && spanEquals(parts->tag, "DATE")){
+            if(parts->value.start == NULL){
                 error->type = INV_RECORD;
                 error->line = lineNumb;
-                return NULL;
+                return;
             }
-            field->tag = malloc(sizeof(char)* (strlen(token) + 1));
-            sprintf(field->tag, "%s", token);
-            token = strtok(NULL, "");
-            if(token == NULL){
-                fclose(inFile);
-                clearList(&a->otherFields);
-                free(a);
+            parseFree(state, event->date);
+            event->date = parseString(state, parts->value);
+        }
+        //retrieve event place
+        else if(parts->level == 2 && spanEquals(parts->tag, "PLAC")){
+            if(parts->value.start == NULL){
                 error->type = INV_RECORD;
                 error->line = lineNumb;
-                return NULL;
+                return;
             }
-            field->value = malloc(sizeof(char)* (strlen(token) + 1));
-            sprintf(field->value, "%s", token);
-            insertBack(&a->otherFields,field);
+            parseFree(state, event->place);
+            event->place = parseIntern(state, parts->value);
         }
+        //create appropariate event field if valid
+        else if(parts->value.start != NULL){
+            parseInsert(state, &event->otherFields, createField(state, parts->tag, parts->value));
+        }
+    }
+    else if(parts->value.start != NULL){
+        parseInsert(state, &fam->otherFields, createField(state, parts->tag, parts->value));
     }
+}
 
-    error->type = OK;
+bool isFamilyEvent(GEDCOMspan tag){
+    char* events[] = {"ANUL", "CENS", "DIV", "DIVF", "ENGA", "MARB", "MARC", "MARR", "MARL", "MARS", "EVEN"};
+
+    for(int i = 0; i < sizeof(events)/sizeof(events[0]); i++){
+        if(spanEquals(tag, events[i])){
+            return true;
+        }
+    }
 
-    fclose(inFile);
-    return a;
+    return false;
 }
 
 char* printName(Individual* toBePrinted){
@@ -2472,7 +2558,7 @@ char* printName(Individual* toBePrinted){
         return "";
     }
     //malloc space for name
-    char* toReturn = malloc(sizeof(char)*52);
+    char* toReturn = malloc(sizeof(char) * (strlen(toBePrinted->givenName) + strlen(toBePrinted->surname) + 8));
     
     //copy name and return printable name
     strcpy(toReturn, "Name: ");
@@ -2503,161 +2589,312 @@ bool findTag(const void* first,const void* second){
     return false;
 }
 
-void recursiveDescendant(List *descendants, Family *family, unsigned int maxGen, int count){
+void addToGeneration(Vector *generations, Individual *individual, int count, void (*deleteFunction)(void* toBeDeleted)){
+    SkipList *generation;
 
-        Individual *individual;
-        ListIterator iter = createIterator(family->children);
+    //generations are found in order, so a new one is always the next one
+    if(getVectorLength(*generations) < count){
+        generation = malloc(sizeof(SkipList));
+        *generation = initializeSkipList(&printIndividual, deleteFunction, &compareSurname);
+        insertBackVector(generations, generation);
+    }
+    else {
+        generation = (SkipList*)getVectorElement(*generations, count - 1);
+    }
 
-        while(iter.current != NULL){
-            individual = (Individual*)iter.current->data;
-            Individual *copy = copyIndi(individual);
-
-            if(maxGen == 0 || count <= maxGen){
-                if(descendants->length < count){
-                    List *generation = malloc(sizeof(List));
-                    *generation = initializeList(&printIndividual, &deleteIndividual, &compareSurname);
-                    insertBack(generation, copy);
-                    insertBack(descendants, generation);
-                } 
-                else {
-                    ListIterator iter = createIterator(*descendants);
-                    List *generation;
-                    for (int i = 1; i < count; ++i){
-                        nextElement(&iter);
-                    }
-                    generation = (List*)iter.current->data;
-                    insertSorted(generation, copy);
-                }
-                Family *family;
-                ListIterator iter = createIterator(individual->families);
-                while(iter.current != NULL){
-                    family = (Family*)iter.current->data;
-                    if(family->wife == individual || family->husband == individual){
-                        recursiveDescendant(descendants, family, maxGen, count + 1);
-                    }
-                    nextElement(&iter);
-                }
-            }
-            nextElement(&iter);
+    insertSkipSorted(generation, individual);
+}
+
+List finishGenerations(Vector *generations){
+    List list = initializeList(&printGeneration, &deleteGeneration, &compareGenerations);
+
+    VectorIterator iter = createVectorIterator(*generations);
+    SkipList *bucket;
+    while((bucket = (SkipList*)nextVectorElement(&iter)) != NULL){
+        List *generation = malloc(sizeof(List));
+        *generation = skipListToList(bucket);
+        free(bucket);
+
+        insertBack(&list, generation);
+    }
+    clearVector(generations);
+
+    return list;
+}
+
+const FamilyGraph* getFamilyGraph(const GEDCOMobject* obj){
+    if(obj == NULL || obj->individuals.deleteData != &arenaDelete){
+        return NULL;
+    }
+
+    return ((const arenaObject*)obj)->graph;
+}
+
+Vector adultFamilies(const Individual *person, bool checkEvents){
+    Vector families = initializeVector(&printFamily, &dummyDelete, &compareFamilies);
+
+    ListIterator iter = createIterator(person->families);
+    while(iter.current != NULL){
+        Family *family = (Family*)iter.current->data;
+        if((family->husband != NULL && compareIndividuals(family->husband,person) == 0 && (!checkEvents || cmpEvent(family->husband,person))) || 
+            (family->wife != NULL && compareIndividuals(family->wife,person) == 0 && (!checkEvents || cmpEvent(family->wife,person)))){
+            insertBackVector(&families, family);
         }
+        nextElement(&iter);
+    }
 
-        return;
+    return families;
 }
 
-void recursiveAnscestor(List *descendants, Family *family, unsigned int maxGen, int count){
+Vector childFamilies(const Individual *person){
+    Vector families = initializeVector(&printFamily, &dummyDelete, &compareFamilies);
 
-    Individual *individual = family->husband;
+    ListIterator iter = createIterator(person->families);
+    while(iter.current != NULL){
+        Family *family = (Family*)iter.current->data;
+        if(family->wife != person && family->husband != person){
+            insertBackVector(&families, family);
+        }
+        nextElement(&iter);
+    }
 
-    if(individual != NULL){
-        Individual *copy = copyIndi(individual);
+    return families;
+}
 
-        if(maxGen == 0 || count <= maxGen){
-            if(descendants->length < count){
-                List *generation = malloc(sizeof(List));
-                *generation = initializeList(&printIndividual, &deleteIndividual, &compareSurname);
-                insertBack(generation, copy);
-                insertBack(descendants, generation);
-            } 
-            else {
-                ListIterator iter = createIterator(*descendants);
-                List *generation;
-                for (int i = 1; i < count; ++i){
-                    nextElement(&iter);
+void addParents(const FamilyGraph *graph, Individual *individual, Vector *parents){
+    int id = graph == NULL ? -1 : getIndividualId(graph, individual);
+    if(id >= 0){
+        for(int e = graph->parentStart[id]; e < graph->parentStart[id + 1]; e++){
+            insertBackVector(parents, graph->individuals[graph->parentIds[e]]);
+        }
+        return;
+    }
+
+    ListIterator iter = createIterator(individual->families);
+    while(iter.current != NULL){
+        Family *family = (Family*)iter.current->data;
+        if(family->wife != individual && family->husband != individual){
+            if(family->husband != NULL){
+                insertBackVector(parents, family->husband);
+            }
+            if(family->wife != NULL){
+                insertBackVector(parents, family->wife);
+            }
+        }
+        nextElement(&iter);
+    }
+}
+
+void initializeSearchSide(searchSide *side, const Individual *person){
+    side->reached = initializeTable(64, &hashPointer, &comparePointers, &free);
+    side->frontier = initializeVector(&printIndividual, &dummyDelete, &compareIndividuals);
+    side->depth = 0;
+
+    relativeStep *step = malloc(sizeof(relativeStep));
+    step->individual = (Individual*)person;
+    step->from = NULL;
+    step->distance = 0;
+    insertTable(&side->reached, step->individual, step);
+    insertBackVector(&side->frontier, step->individual);
+}
+
+void expandSearchSide(const FamilyGraph *graph, searchSide *side, searchSide *other, Vector *meetings, int *best){
+    Vector next = initializeVector(&printIndividual, &dummyDelete, &compareIndividuals);
+    Vector parents = initializeVector(&printIndividual, &dummyDelete, &compareIndividuals);
+    side->depth++;
+
+    VectorIterator iter = createVectorIterator(side->frontier);
+    Individual *individual;
+    while((individual = (Individual*)nextVectorElement(&iter)) != NULL){
+        addParents(graph, individual, &parents);
+
+        VectorIterator parentIter = createVectorIterator(parents);
+        Individual *parent;
+        while((parent = (Individual*)nextVectorElement(&parentIter)) != NULL){
+            if(lookupTable(side->reached, parent) != NULL){
+                continue;
+            }
+
+            relativeStep *step = malloc(sizeof(relativeStep));
+            step->individual = parent;
+            step->from = individual;
+            step->distance = side->depth;
+            insertTable(&side->reached, parent, step);
+            insertBackVector(&next, parent);
+
+            //every common ancestor is found exactly once, by the second side to reach it
+            relativeStep *meeting = (relativeStep*)lookupTable(other->reached, parent);
+            if(meeting != NULL){
+                insertBackVector(meetings, parent);
+                if(*best < 0 || side->depth + meeting->distance < *best){
+                    *best = side->depth + meeting->distance;
                 }
+            }
+        }
+        clearVector(&parents);
+    }
+
+    clearVector(&side->frontier);
+    side->frontier = next;
+}
+
+void clearSearchSide(searchSide *side){
+    clearTable(&side->reached);
+    clearVector(&side->frontier);
+}
 
-                generation = (List*)iter.current->data;
-                insertSorted(generation, copy);
+void addRelatives(HashTable *visited, Vector *found, Family *family, traverseDirection direction){
+    if(direction == DESCENDANT_LINKS){
+        ListIterator iter = createIterator(family->children);
+        while(iter.current != NULL){
+            Individual *child = (Individual*)iter.current->data;
+            //a relative already reached through another line is not added again
+            if(insertTable(visited, child, child)){
+                insertBackVector(found, child);
             }
+            nextElement(&iter);
+        }
+    }
+    else {
+        if(family->husband != NULL && insertTable(visited, family->husband, family->husband)){
+            insertBackVector(found, family->husband);
+        }
+        if(family->wife != NULL && insertTable(visited, family->wife, family->wife)){
+            insertBackVector(found, family->wife);
+        }
+    }
+}
+
+int *firstGenerationIds(const FamilyGraph *graph, Vector *start, traverseDirection direction, int *count){
+    int length = 0;
+    VectorIterator famIter = createVectorIterator(*start);
+    Family *family;
+    while((family = (Family*)nextVectorElement(&famIter)) != NULL){
+        length += direction == DESCENDANT_LINKS ? getLength(family->children) : 2;
+    }
+
+    int *ids = malloc(sizeof(int) * (length + 1));
+    if(ids == NULL){
+        return NULL;
+    }
 
-            Family *family;
-            ListIterator iter = createIterator(individual->families);
+    //the same relatives in the same order as addRelatives, duplicates are left to the walk's visited set
+    *count = 0;
+    famIter = createVectorIterator(*start);
+    while((family = (Family*)nextVectorElement(&famIter)) != NULL){
+        if(direction == DESCENDANT_LINKS){
+            ListIterator iter = createIterator(family->children);
             while(iter.current != NULL){
-                family = (Family*)iter.current->data;
-                if(family->wife != individual && family->husband != individual){
-                    recursiveAnscestor(descendants, family, maxGen, count+1);
-                }
+                ids[(*count)++] = getIndividualId(graph, (Individual*)iter.current->data);
                 nextElement(&iter);
             }
-        } 
+        }
+        else {
+            if(family->husband != NULL){
+                ids[(*count)++] = getIndividualId(graph, family->husband);
+            }
+            if(family->wife != NULL){
+                ids[(*count)++] = getIndividualId(graph, family->wife);
+            }
+        }
+    }
 
+    for(int i = 0; i < *count; i++){
+        if(ids[i] < 0){
+            free(ids);
+            return NULL;
+        }
     }
 
+    return ids;
+}
+
+void traverseRelatives(const GEDCOMobject *familyRecord, const Individual *person, Vector *start, traverseDirection direction, unsigned int maxGen, void (*visit)(Individual *relative, int generation, void *state), void *state){
+    const FamilyGraph *graph = getFamilyGraph(familyRecord);
+    int id = graph == NULL ? -1 : getIndividualId(graph, person);
+    if(id >= 0){
+        //the walk starts from the caller's families, not the person's edges, so both ways pick the same families
+        int count;
+        int *first = firstGenerationIds(graph, start, direction, &count);
+        if(first != NULL){
+            traverseGraph(graph, id, first, count, direction, maxGen, visit, state);
+            free(first);
+            return;
+        }
+    }
 
-    individual = family->wife;
+    HashTable visited = initializeTable(64, &hashPointer, &comparePointers, &dummyDelete);
+    insertTable(&visited, person, (void*)person);
 
-    if(individual != NULL){
-        Individual *copy = copyIndi(individual);
+    Vector frontier = initializeVector(&printIndividual, &dummyDelete, &compareIndividuals);
+    VectorIterator famIter = createVectorIterator(*start);
+    Family *family;
+    while((family = (Family*)nextVectorElement(&famIter)) != NULL){
+        addRelatives(&visited, &frontier, family, direction);
+    }
 
-        if(maxGen == 0 || count <= maxGen){
-            if(descendants->length < count){
-                List *generation = malloc(sizeof(List));
-                *generation = initializeList(&printIndividual, &deleteIndividual, &compareSurname);
-                insertBack(generation, copy);
-                insertBack(descendants, generation);         
-            } 
-            else {
-                ListIterator iter = createIterator(*descendants);
-                List *generation;
-                for (int i = 1; i < count; ++i){
-                    nextElement(&iter);
-                }
+    //each pass handles one whole generation, so the generation of a relative is the pass it is found in
+    int generation = 1;
+    while(getVectorLength(frontier) > 0){
+        Vector next = initializeVector(&printIndividual, &dummyDelete, &compareIndividuals);
+
+        VectorIterator iter = createVectorIterator(frontier);
+        Individual *individual;
+        while((individual = (Individual*)nextVectorElement(&iter)) != NULL){
+            visit(individual, generation, state);
 
-                generation = (List*)iter.current->data;
-                insertSorted(generation, copy);
+            if(maxGen != 0 && generation >= maxGen){
+                continue;
             }
-                
-            Family *family;
-            ListIterator iter = createIterator(individual->families);
-            while(iter.current != NULL){
-                family = (Family*)iter.current->data;
-                if(family->wife != individual && family->husband != individual){
-                    recursiveAnscestor(descendants, family, maxGen, count+1);
+
+            ListIterator links = createIterator(individual->families);
+            while(links.current != NULL){
+                family = (Family*)links.current->data;
+                bool adult = family->wife == individual || family->husband == individual;
+                //descendants continue through the families a relative is an adult of, ancestors through the others
+                if(adult == (direction == DESCENDANT_LINKS)){
+                    addRelatives(&visited, &next, family, direction);
                 }
-                nextElement(&iter);
+                nextElement(&links);
             }
-        } 
+        }
+
+        clearVector(&frontier);
+        frontier = next;
+        generation++;
     }
 
-    return;
+    clearVector(&frontier);
+    clearTable(&visited);
 }
 
-int compareSurname(const void* a,const void* b){
-    Individual* first = (Individual*)a;
-    Individual* second = (Individual*)b;
+void collectRelative(Individual *relative, int generation, void *state){
+    insertBack((List*)state, copyIndi(relative));
+}
 
-    if(strcmp(first->surname,second->surname) != 0){
-        return strcmp(first->surname,second->surname);
-    }
+void collectGeneration(Individual *relative, int generation, void *state){
+    addToGeneration((Vector*)state, copyIndi(relative), generation, &deleteIndividual);
+}
 
-    return strcmp(first->givenName,second->givenName);
+void collectRelativeView(Individual *relative, int generation, void *state){
+    insertBack((List*)state, relative);
 }
 
-bool findFamily(const void* a,const void* b){
-    Family* first = ((storeFam*)a)->temp;
-    Family* second = (Family*)b;
+void collectGenerationView(Individual *relative, int generation, void *state){
+    addToGeneration((Vector*)state, relative, generation, &dummyDelete);
+}
 
-    if(first->husband == NULL && second->husband == NULL && 
-        first->wife == NULL && second->wife == NULL &&
-        first->children.length == second->children.length){
-        return true;
-    }
-    else if(first->husband == NULL && second->husband == NULL && 
-        compareIndividuals(first->wife, second->wife) == 0 &&
-        first->children.length == second->children.length){
-        return true;
-    }
-    else if(compareIndividuals(first->husband, second->husband) == 0 && 
-        first->wife == NULL && second->wife == NULL &&
-        first->children.length == second->children.length){
-        return true;
-    }
-    else if(compareIndividuals(first->husband, second->husband) == 0 && 
-        compareIndividuals(first->wife, second->wife) == 0 &&
-        first->children.length == second->children.length){
-        return true;
+int compareSurname(const void* a,const void* b){
+    Individual* first = (Individual*)a;
+    Individual* second = (Individual*)b;
+
+    //pooled names are equal exactly when they are the same pointer
+    int result = first->surname == second->surname ? 0 : strcmp(first->surname,second->surname);
+    if(result != 0){
+        return result;
     }
 
-    return false;
+    return first->givenName == second->givenName ? 0 : strcmp(first->givenName,second->givenName);
 }
 
 bool findIndividual(const void* a,const void* b){
@@ -2671,6 +2908,13 @@ bool findIndividual(const void* a,const void* b){
     return false;
 }
 
+bool findName(const void* a,const void* b){
+    const Individual* first = (const Individual*)a;
+    const Individual* second = (const Individual*)b;
+
+    return first->givenName != NULL && first->surname != NULL && strcmp(first->givenName, second->givenName) == 0 && strcmp(first->surname, second->surname) == 0;
+}
+
 bool findIndi(const void* a,const void* b){
     Individual* first = (Individual*)a;
     Individual* second = (Individual*)b;
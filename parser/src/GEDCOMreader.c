@@ -0,0 +1,413 @@
+#define _DEFAULT_SOURCE
+
+#include "GEDCOMreader.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+GEDCOMreader* createReader(char* fileName){
+    if(fileName == NULL){
+        return NULL;
+    }
+
+    int fd = open(fileName, O_RDONLY);
+    if(fd < 0){
+        return NULL;
+    }
+
+    GEDCOMreader* reader = malloc(sizeof(GEDCOMreader));
+    reader->fd = fd;
+    reader->mapped = false;
+    reader->borrowed = false;
+    reader->size = READER_CHUNK;
+    reader->buffer = malloc(sizeof(char) * reader->size);
+    reader->start = 0;
+    reader->end = 0;
+    reader->eof = false;
+    reader->lastStart = 0;
+    reader->released = 0;
+    reader->lineNumb = 0;
+    reader->fold = NULL;
+    reader->foldSize = 0;
+    reader->firstLength = 0;
+    reader->foldNumb = 0;
+
+    return reader;
+}
+
+GEDCOMreader* createMappedReader(char* fileName){
+    if(fileName == NULL){
+        return NULL;
+    }
+
+    int fd = open(fileName, O_RDONLY);
+    if(fd < 0){
+        return NULL;
+    }
+
+    struct stat info;
+    if(fstat(fd, &info) != 0){
+        close(fd);
+        return NULL;
+    }
+
+    //an empty file cannot be mapped, it simply has no lines
+    char* buffer = NULL;
+    if(info.st_size > 0){
+        buffer = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(buffer == MAP_FAILED){
+            close(fd);
+            return NULL;
+        }
+        madvise(buffer, info.st_size, MADV_SEQUENTIAL);
+    }
+
+    GEDCOMreader* reader = malloc(sizeof(GEDCOMreader));
+    reader->fd = fd;
+    reader->mapped = true;
+    reader->borrowed = false;
+    reader->size = info.st_size;
+    reader->buffer = buffer;
+    reader->start = 0;
+    reader->end = info.st_size;
+    reader->eof = true;
+    reader->lastStart = 0;
+    reader->released = 0;
+    reader->lineNumb = 0;
+    reader->fold = NULL;
+    reader->foldSize = 0;
+    reader->firstLength = 0;
+    reader->foldNumb = 0;
+
+    return reader;
+}
+
+GEDCOMreader* createMemoryReader(const char* data, size_t size){
+    if(data == NULL && size > 0){
+        return NULL;
+    }
+
+    //the data is read just like a mapping, which is already complete
+    GEDCOMreader* reader = malloc(sizeof(GEDCOMreader));
+    reader->fd = -1;
+    reader->mapped = true;
+    reader->borrowed = true;
+    reader->size = size;
+    reader->buffer = (char*)data;
+    reader->start = 0;
+    reader->end = size;
+    reader->eof = true;
+    reader->lastStart = 0;
+    reader->released = 0;
+    reader->lineNumb = 0;
+    reader->fold = NULL;
+    reader->foldSize = 0;
+    reader->firstLength = 0;
+    reader->foldNumb = 0;
+
+    return reader;
+}
+
+/** Function to read the next block of the file in behind the unread data
+ * Unread data is moved to the front of the buffer first, and the buffer doubles if it is still full.
+ *@return true if more data was read, false at the end of the file
+ *@param reader - the reader
+ **/
+static bool fillReader(GEDCOMreader* reader){
+    if(reader->eof){
+        return false;
+    }
+
+    if(reader->start > 0){
+        memmove(reader->buffer, reader->buffer + reader->start, reader->end - reader->start);
+        reader->end -= reader->start;
+        reader->start = 0;
+    }
+
+    if(reader->end == reader->size){
+        reader->size *= 2;
+        reader->buffer = realloc(reader->buffer, sizeof(char) * reader->size);
+    }
+
+    ssize_t got;
+    do{
+        got = read(reader->fd, reader->buffer + reader->end, reader->size - reader->end);
+    }while(got < 0 && errno == EINTR);
+
+    if(got <= 0){
+        reader->eof = true;
+        return false;
+    }
+
+    reader->end += got;
+    return true;
+}
+
+/** Function to let the kernel drop mapped pages that have already been read
+ * The pages are read back in from the file if they are touched again, so earlier slices stay valid.
+ *@param reader - the reader
+ **/
+static void releaseMapped(GEDCOMreader* reader){
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t upTo = reader->lastStart & ~(page - 1);
+
+    if(upTo - reader->released >= READER_RELEASE){
+        madvise(reader->buffer + reader->released, upTo - reader->released, MADV_DONTNEED);
+        reader->released = upTo;
+    }
+}
+
+const char* readLine(GEDCOMreader* reader, size_t* length){
+    if(reader == NULL){
+        return NULL;
+    }
+
+    if(reader->mapped && !reader->borrowed){
+        releaseMapped(reader);
+    }
+
+    //offset from start that has already been searched for a terminator
+    size_t scanned = 0;
+
+    while(1){
+        const char* from = reader->buffer + reader->start + scanned;
+        const char* last = reader->buffer + reader->end;
+
+        const char* term = memchr(from, '\n', last - from);
+        const char* carriage = memchr(from, '\r', (term == NULL ? last : term) - from);
+        if(carriage != NULL){
+            term = carriage;
+        }
+
+        if(term != NULL){
+            size_t pos = term - reader->buffer;
+
+            //the other half of a CRLF or LFCR pair may still be in the file
+            if(pos + 1 == reader->end && !reader->eof){
+                scanned = pos - reader->start;
+                fillReader(reader);
+                continue;
+            }
+
+            size_t next = pos + 1;
+            if(next < reader->end && (reader->buffer[next] == '\r' || reader->buffer[next] == '\n') && reader->buffer[next] != *term){
+                next++;
+            }
+
+            const char* line = reader->buffer + reader->start;
+            if(length != NULL){
+                *length = pos - reader->start;
+            }
+            reader->lastStart = reader->start;
+            reader->start = next;
+            reader->lineNumb++;
+
+            return line;
+        }
+
+        scanned = reader->end - reader->start;
+        if(fillReader(reader)){
+            continue;
+        }
+
+        //last line of a file without a final terminator
+        if(reader->start == reader->end){
+            return NULL;
+        }
+
+        const char* line = reader->buffer + reader->start;
+        if(length != NULL){
+            *length = reader->end - reader->start;
+        }
+        reader->lastStart = reader->start;
+        reader->start = reader->end;
+        reader->lineNumb++;
+
+        return line;
+    }
+}
+
+/** Function to check if a line is a CONT or CONC line and find its value
+ *@return true if the line continues the one before it
+ *@param line to check, not nul terminated
+ *@param length of the line
+ *@param newline - set to true for CONT, which starts a new line in the value
+ *@param value - set to the start of the value
+ *@param valueLength - set to the length of the value
+ **/
+static bool isContinuation(const char* line, size_t length, bool* newline, const char** value, size_t* valueLength){
+    const char* cur = line;
+    const char* last = line + length;
+
+    //level number, then an optional cross reference pointer
+    if(cur == last || *cur < '0' || *cur > '9'){
+        return false;
+    }
+    while(cur < last && *cur >= '0' && *cur <= '9'){
+        cur++;
+    }
+    while(cur < last && *cur == ' '){
+        cur++;
+    }
+    if(cur < last && *cur == '@'){
+        while(cur < last && *cur != ' '){
+            cur++;
+        }
+        while(cur < last && *cur == ' '){
+            cur++;
+        }
+    }
+
+    //tag must be exactly CONT or CONC
+    if(last - cur < 4 || (memcmp(cur, "CONT", 4) != 0 && memcmp(cur, "CONC", 4) != 0)){
+        return false;
+    }
+    *newline = cur[3] == 'T';
+    cur += 4;
+    if(cur < last && *cur != ' '){
+        return false;
+    }
+
+    while(cur < last && *cur == ' '){
+        cur++;
+    }
+    *value = cur;
+    *valueLength = last - cur;
+
+    return true;
+}
+
+/** Function to append to the fold buffer, growing it if needed
+ *@param reader - the reader
+ *@param used - number of characters already in the fold buffer
+ *@param text - the text to add
+ *@param length - length of the text
+ **/
+static void appendFold(GEDCOMreader* reader, size_t used, const char* text, size_t length){
+    if(used + length + 1 > reader->foldSize){
+        size_t size = reader->foldSize == 0 ? 256 : reader->foldSize;
+        while(used + length + 1 > size){
+            size *= 2;
+        }
+        reader->fold = realloc(reader->fold, sizeof(char) * size);
+        reader->foldSize = size;
+    }
+
+    memcpy(reader->fold + used, text, length);
+}
+
+const char* readFoldedLine(GEDCOMreader* reader, size_t* length){
+    if(reader == NULL){
+        return NULL;
+    }
+
+    //blank lines are skipped
+    size_t used;
+    const char* line;
+    do{
+        line = readLine(reader, &used);
+        if(line == NULL){
+            return NULL;
+        }
+    }while(used == 0);
+
+    reader->firstLength = used;
+    reader->foldNumb = reader->lineNumb;
+
+    //a buffered line can move when the next one is read, so it is copied first
+    bool folded = false;
+    if(!reader->mapped){
+        appendFold(reader, 0, line, used);
+        folded = true;
+    }
+
+    //look one line ahead, a continuation is appended and anything else is given back
+    while(1){
+        size_t nextLength;
+        const char* next;
+        do{
+            next = readLine(reader, &nextLength);
+        }while(next != NULL && nextLength == 0);
+
+        if(next == NULL){
+            break;
+        }
+
+        bool newline;
+        const char* value;
+        size_t valueLength;
+        if(!isContinuation(next, nextLength, &newline, &value, &valueLength)){
+            unreadLine(reader);
+            break;
+        }
+
+        if(!folded){
+            appendFold(reader, 0, line, used);
+            folded = true;
+        }
+        if(newline){
+            appendFold(reader, used, "\n", 1);
+            used++;
+        }
+        appendFold(reader, used, value, valueLength);
+        used += valueLength;
+    }
+
+    if(length != NULL){
+        *length = used;
+    }
+    if(folded){
+        reader->fold[used] = '\0';
+        return reader->fold;
+    }
+
+    return line;
+}
+
+void unreadLine(GEDCOMreader* reader){
+    if(reader == NULL || reader->lineNumb == 0){
+        return;
+    }
+
+    reader->start = reader->lastStart;
+    reader->lineNumb--;
+}
+
+bool endOfReader(GEDCOMreader* reader){
+    if(reader == NULL){
+        return true;
+    }
+
+    if(reader->start < reader->end){
+        return false;
+    }
+
+    return !fillReader(reader);
+}
+
+void deleteReader(GEDCOMreader* reader){
+    if(reader == NULL){
+        return;
+    }
+
+    //borrowed data is not the reader's to give back
+    if(reader->mapped){
+        if(reader->buffer != NULL && !reader->borrowed){
+            munmap(reader->buffer, reader->size);
+        }
+    }
+    else{
+        free(reader->buffer);
+    }
+    free(reader->fold);
+    if(reader->fd >= 0){
+        close(reader->fd);
+    }
+    free(reader);
+}
@@ -0,0 +1,292 @@
+#define _DEFAULT_SOURCE
+
+#include "GEDCOMsession.h"
+#include "GEDCOMutilities.h"
+#include "GEDCOMcache.h"
+#include "GEDCOMbatch.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+//handles are a slot of the sessions array in the low bits and how often that slot was reused above them
+#define SESSION_SLOT_BITS 16
+#define SESSION_SLOTS (1 << SESSION_SLOT_BITS)
+#define SESSION_GENERATIONS (1 << (31 - SESSION_SLOT_BITS))
+
+//an open file and the object it was parsed into
+typedef struct{
+    char* path;
+    GEDCOMobject* obj;
+
+    //queries hold it shared, changes exclusive
+    pthread_rwlock_t lock;
+    //the sessions array holds one reference until the session is closed, every call using it holds another
+    int references;
+} gedcomSession;
+
+//a place in the sessions array, session is NULL while the slot is free
+typedef struct{
+    gedcomSession* session;
+    int generation;
+} sessionSlot;
+
+static sessionSlot* sessions = NULL;
+static int sessionCount = 0;
+static int sessionCapacity = 0;
+static pthread_mutex_t sessionLock = PTHREAD_MUTEX_INITIALIZER;
+
+/** Function to find the session of a handle and keep it from being freed until releaseSession
+*@return the session, NULL if the handle is invalid or closed
+*@param session - handle of the session
+**/
+static gedcomSession* findSession(int session){
+    if(session < 0){
+        return NULL;
+    }
+    int slot = session & (SESSION_SLOTS - 1);
+    int generation = session >> SESSION_SLOT_BITS;
+
+    pthread_mutex_lock(&sessionLock);
+    gedcomSession* found = NULL;
+    if(slot < sessionCount && sessions[slot].generation == generation){
+        found = sessions[slot].session;
+    }
+    if(found != NULL){
+        found->references++;
+    }
+    pthread_mutex_unlock(&sessionLock);
+
+    return found;
+}
+
+/** Function to give back a reference to a session, the last one frees it
+*@param found - the session
+**/
+static void releaseSession(gedcomSession* found){
+    pthread_mutex_lock(&sessionLock);
+    bool last = --found->references == 0;
+    pthread_mutex_unlock(&sessionLock);
+
+    if(!last){
+        return;
+    }
+
+    pthread_rwlock_destroy(&found->lock);
+    deleteGEDCOM(found->obj);
+    free(found->path);
+    free(found);
+}
+
+/** Function to make a newly allocated copy of a string for a JSON result
+*@return the copy
+*@param str - the string
+**/
+static char* copyResult(const char* str){
+    char* copy = malloc(sizeof(char) * (strlen(str) + 1));
+    strcpy(copy, str);
+
+    return copy;
+}
+
+int openSession(char* fileName){
+    //sessions change their objects, so they are parsed with the default loader rather than taken from the cache
+    GEDCOMobject* obj = NULL;
+    GEDCOMerror error = createGEDCOM(fileName, &obj);
+    if(error.type != OK){
+        return -1;
+    }
+
+    gedcomSession* opened = malloc(sizeof(gedcomSession));
+    char* path = malloc(sizeof(char) * (strlen(fileName) + 1));
+    if(opened == NULL || path == NULL){
+        free(opened);
+        free(path);
+        deleteGEDCOM(obj);
+        return -1;
+    }
+    strcpy(path, fileName);
+    opened->path = path;
+    opened->obj = obj;
+    opened->references = 1;
+    pthread_rwlock_init(&opened->lock, NULL);
+
+    pthread_mutex_lock(&sessionLock);
+
+    //closed slots are used again before the array grows
+    int slot = 0;
+    while(slot < sessionCount && sessions[slot].session != NULL){
+        slot++;
+    }
+    if(slot == sessionCount && sessionCount == sessionCapacity){
+        int capacity = sessionCapacity == 0 ? 8 : sessionCapacity * 2;
+        sessionSlot* grown = capacity <= SESSION_SLOTS ? realloc(sessions, sizeof(sessionSlot) * capacity) : NULL;
+        if(grown == NULL){
+            pthread_mutex_unlock(&sessionLock);
+            pthread_rwlock_destroy(&opened->lock);
+            free(path);
+            free(opened);
+            deleteGEDCOM(obj);
+            return -1;
+        }
+        sessions = grown;
+        sessionCapacity = capacity;
+    }
+    if(slot == sessionCount){
+        sessions[slot].generation = 0;
+        sessionCount++;
+    }
+    sessions[slot].session = opened;
+    int handle = (sessions[slot].generation << SESSION_SLOT_BITS) | slot;
+
+    pthread_mutex_unlock(&sessionLock);
+
+    return handle;
+}
+
+void closeSession(int session){
+    if(session < 0){
+        return;
+    }
+    int slot = session & (SESSION_SLOTS - 1);
+    int generation = session >> SESSION_SLOT_BITS;
+
+    pthread_mutex_lock(&sessionLock);
+    gedcomSession* closed = NULL;
+    if(slot < sessionCount && sessions[slot].generation == generation){
+        closed = sessions[slot].session;
+        sessions[slot].session = NULL;
+        //the old handle of the slot stops working
+        sessions[slot].generation = (generation + 1) % SESSION_GENERATIONS;
+    }
+    pthread_mutex_unlock(&sessionLock);
+
+    //calls still using the session free it once they are done
+    if(closed != NULL){
+        releaseSession(closed);
+    }
+}
+
+GEDCOMobject* getSessionGEDCOM(int session){
+    gedcomSession* found = findSession(session);
+    if(found == NULL){
+        return NULL;
+    }
+
+    //the array's own reference keeps the object until the session is closed
+    GEDCOMobject* obj = found->obj;
+    releaseSession(found);
+
+    return obj;
+}
+
+char* sessionSummaryJSON(int session){
+    gedcomSession* found = findSession(session);
+    if(found == NULL){
+        return copyResult("{}");
+    }
+
+    pthread_rwlock_rdlock(&found->lock);
+    char* toReturn = summaryToJSON(found->obj);
+    pthread_rwlock_unlock(&found->lock);
+    releaseSession(found);
+
+    return toReturn;
+}
+
+char* sessionIndividualsJSON(int session){
+    gedcomSession* found = findSession(session);
+    if(found == NULL){
+        return copyResult("[]");
+    }
+
+    pthread_rwlock_rdlock(&found->lock);
+    char* toReturn = iListToJSON(found->obj->individuals);
+    pthread_rwlock_unlock(&found->lock);
+    releaseSession(found);
+
+    return toReturn;
+}
+
+char* sessionDescendantsJSON(int session, char* firstname, char* lastname, int num){
+    gedcomSession* found = findSession(session);
+    if(found == NULL){
+        return copyResult("[]");
+    }
+
+    pthread_rwlock_rdlock(&found->lock);
+    char* toReturn = relativesToJSON(found->obj, firstname, lastname, num, DESCENDANT_LINKS);
+    pthread_rwlock_unlock(&found->lock);
+    releaseSession(found);
+
+    return toReturn;
+}
+
+char* sessionAncestorsJSON(int session, char* firstname, char* lastname, int num){
+    gedcomSession* found = findSession(session);
+    if(found == NULL){
+        return copyResult("[]");
+    }
+
+    pthread_rwlock_rdlock(&found->lock);
+    char* toReturn = relativesToJSON(found->obj, firstname, lastname, num, ANCESTOR_LINKS);
+    pthread_rwlock_unlock(&found->lock);
+    releaseSession(found);
+
+    return toReturn;
+}
+
+char* sessionBatchJSON(int session, char* queries, int threads){
+    gedcomSession* found = findSession(session);
+    if(found == NULL){
+        return copyResult("{}");
+    }
+
+    //the threads of the batch only read the object, so it is held shared like any other query
+    pthread_rwlock_rdlock(&found->lock);
+    char* toReturn = batchToJSON(found->obj, queries, threads);
+    pthread_rwlock_unlock(&found->lock);
+    releaseSession(found);
+
+    return toReturn;
+}
+
+bool sessionAddIndividual(int session, char* firstname, char* lastname){
+    //a line break in a name would write records of the caller's choosing into the file
+    if(!validNewName(firstname, lastname)){
+        return false;
+    }
+    gedcomSession* found = findSession(session);
+    if(found == NULL){
+        return false;
+    }
+
+    Individual* indi = createNamedIndividual(firstname, lastname);
+    if(indi != NULL){
+        pthread_rwlock_wrlock(&found->lock);
+        addIndividual(found->obj, indi);
+        pthread_rwlock_unlock(&found->lock);
+    }
+    releaseSession(found);
+
+    return indi != NULL;
+}
+
+int sessionWrite(int session, char* fileName){
+    gedcomSession* found = findSession(session);
+    if(found == NULL){
+        return INV_FILE;
+    }
+
+    char* path = (fileName == NULL || fileName[0] == '\0') ? found->path : fileName;
+    pthread_rwlock_wrlock(&found->lock);
+    GEDCOMerror error = writeGEDCOM(path, found->obj);
+
+    //whatever was cached for the file is out of date now
+    invalidateGEDCOM(path);
+    pthread_rwlock_unlock(&found->lock);
+    releaseSession(found);
+
+    return error.type;
+}
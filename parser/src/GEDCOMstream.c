@@ -0,0 +1,156 @@
+#include "GEDCOMstream.h"
+#include "GEDCOMutilities.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+/** Function to find the kind of record a level 0 line starts, only the first record of a file is its header
+*@return the record type
+*@param line - the level 0 line
+**/
+static recordType typeOfRecord(const GEDCOMline* line){
+    if(spanEquals(line->tag, "INDI")){
+        return INDI_RECORD;
+    }
+    if(spanEquals(line->tag, "FAM")){
+        return FAM_RECORD;
+    }
+    if(spanEquals(line->tag, "SUBM")){
+        return SUBM_RECORD;
+    }
+    return NO_RECORD;
+}
+
+GEDCOMreader* openStream(char* fileName, int flags, GEDCOMline* head, GEDCOMerror* error){
+    error->type = OK;
+    error->line = -1;
+
+    //validate file tag
+    char* extension = fileName == NULL ? NULL : strrchr(fileName, '.');
+    if(extension == NULL || strcmp(extension, ".ged") != 0){
+        error->type = INV_FILE;
+        return NULL;
+    }
+
+    GEDCOMreader* reader = (flags & LOAD_MMAP) ? createMappedReader(fileName) : createReader(fileName);
+    int lineNumb = 0;
+
+    //check if file was opened properly and is readable
+    if(reader == NULL){
+        error->type = INV_FILE;
+        return NULL;
+    }
+
+    if(!readGEDCOMline(reader, head, &lineNumb, error)){
+        error->type = INV_FILE;
+        error->line = -1;
+        deleteReader(reader);
+        return NULL;
+    }
+
+    //validate header first line
+    if(head->level != 0 && spanEquals(head->tag, "HEAD")){
+        error->type = INV_HEADER;
+        deleteReader(reader);
+        return NULL;
+    }
+    else if(head->level != 0 || head->xref.start != NULL || !spanEquals(head->tag, "HEAD")){
+        error->type = INV_GEDCOM;
+        deleteReader(reader);
+        return NULL;
+    }
+
+    return reader;
+}
+
+recordType streamRecords(GEDCOMreader* reader, const GEDCOMhandler* handler, recordType record, bool last, bool* trailer, GEDCOMerror* error){
+    GEDCOMline parts;
+    int lineNumb = 0;
+    *trailer = false;
+
+    //every record is handed out as its lines go by
+    while(error->type == OK){
+        if(!readGEDCOMline(reader, &parts, &lineNumb, error)){
+            //a part that is not the last simply runs out, a line that is too long is an error wherever it is
+            bool ended = error->type == OTHER_ERROR || (last && endOfReader(reader));
+            if(ended && !last){
+                error->type = OK;
+            }
+            else if(record == HEAD_RECORD){
+                error->type = INV_HEADER;
+                error->line = ended ? lineNumb + 1 : lineNumb;
+            }
+            else if(ended){
+                error->type = INV_GEDCOM;
+                error->line = -1;
+            }
+            else{
+                error->type = INV_RECORD;
+                error->line = lineNumb;
+            }
+            break;
+        }
+
+        if(parts.tag.start == NULL){
+            error->type = record == HEAD_RECORD ? INV_HEADER : INV_RECORD;
+            error->line = lineNumb;
+            break;
+        }
+
+        if(parts.level == 0){
+            if(handler->endRecord != NULL){
+                handler->endRecord(record, lineNumb, error, handler->state);
+                if(error->type != OK){
+                    break;
+                }
+            }
+
+            //check if trailer and end reading
+            if(spanEquals(parts.tag, "TRLR")){
+                *trailer = true;
+                break;
+            }
+
+            record = typeOfRecord(&parts);
+            if(handler->startRecord != NULL){
+                handler->startRecord(record, &parts, lineNumb, error, handler->state);
+            }
+        }
+        else if(handler->recordLine != NULL){
+            handler->recordLine(record, &parts, lineNumb, error, handler->state);
+        }
+    }
+
+    return record;
+}
+
+GEDCOMerror streamGEDCOM(char* fileName, const GEDCOMhandler* handler, int flags){
+    GEDCOMerror error;
+    error.type = OK;
+    error.line = -1;
+
+    //check if filename exists
+    if(fileName == NULL || handler == NULL){
+        error.type = INV_FILE;
+        return error;
+    }
+
+    GEDCOMline head;
+    GEDCOMreader* reader = openStream(fileName, flags, &head, &error);
+    if(reader == NULL){
+        return error;
+    }
+
+    if(handler->startRecord != NULL){
+        handler->startRecord(HEAD_RECORD, &head, reader->foldNumb, &error, handler->state);
+    }
+
+    //read the whole file once, the end of it is the end of the last record
+    bool trailer;
+    streamRecords(reader, handler, HEAD_RECORD, true, &trailer, &error);
+
+    deleteReader(reader);
+
+    return error;
+}
@@ -0,0 +1,206 @@
+#define _DEFAULT_SOURCE
+
+#include "GEDCOMwriter.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+GEDCOMwriter* createWriter(char* fileName){
+    if(fileName == NULL){
+        return NULL;
+    }
+
+    int fd = open(fileName, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if(fd < 0){
+        return NULL;
+    }
+
+    GEDCOMwriter* writer = malloc(sizeof(GEDCOMwriter));
+    char* buffer = malloc(sizeof(char) * WRITER_BUFFER);
+    if(writer == NULL || buffer == NULL){
+        free(writer);
+        free(buffer);
+        close(fd);
+        return NULL;
+    }
+
+    writer->fd = fd;
+    writer->buffer = buffer;
+    writer->size = WRITER_BUFFER;
+    writer->used = 0;
+    writer->written = 0;
+    writer->failed = false;
+
+    return writer;
+}
+
+GEDCOMwriter* createMemoryWriter(void){
+    GEDCOMwriter* writer = malloc(sizeof(GEDCOMwriter));
+    char* buffer = malloc(sizeof(char) * WRITER_BUFFER);
+    if(writer == NULL || buffer == NULL){
+        free(writer);
+        free(buffer);
+        return NULL;
+    }
+
+    writer->fd = -1;
+    writer->buffer = buffer;
+    writer->size = WRITER_BUFFER;
+    writer->used = 0;
+    writer->written = 0;
+    writer->failed = false;
+
+    return writer;
+}
+
+/** Function to make room for more text in the buffer of a memory writer
+ *@return false if there is no memory for it
+ *@param writer - the memory writer
+ *@param length - the number of characters that have to fit
+ **/
+static bool growWriter(GEDCOMwriter* writer, size_t length){
+    size_t size = writer->size;
+    while(length > size - writer->used){
+        size *= 2;
+    }
+
+    char* buffer = realloc(writer->buffer, sizeof(char) * size);
+    if(buffer == NULL){
+        writer->failed = true;
+        return false;
+    }
+    writer->buffer = buffer;
+    writer->size = size;
+
+    return true;
+}
+
+/** Function to write the buffer to the file followed by more text, in one system call unless the file takes less
+ * The buffer is empty afterwards.
+ *@param writer - the writer
+ *@param text - characters to write after the buffer, may be NULL if length is 0
+ *@param length - the number of characters
+ **/
+static void writeOut(GEDCOMwriter* writer, const char* text, size_t length){
+    struct iovec parts[2];
+    parts[0].iov_base = writer->buffer;
+    parts[0].iov_len = writer->used;
+    parts[1].iov_base = (void*)text;
+    parts[1].iov_len = length;
+
+    int first = 0;
+    while(!writer->failed){
+        while(first < 2 && parts[first].iov_len == 0){
+            first++;
+        }
+        if(first == 2){
+            break;
+        }
+
+        ssize_t done = writev(writer->fd, parts + first, 2 - first);
+        if(done < 0 && errno == EINTR){
+            continue;
+        }
+        if(done <= 0){
+            writer->failed = true;
+            break;
+        }
+        writer->written += done;
+
+        //a short write leaves the rest to go again
+        while(first < 2 && (size_t)done >= parts[first].iov_len){
+            done -= parts[first].iov_len;
+            parts[first].iov_len = 0;
+            first++;
+        }
+        if(first < 2){
+            parts[first].iov_base = (char*)parts[first].iov_base + done;
+            parts[first].iov_len -= done;
+        }
+    }
+
+    writer->used = 0;
+}
+
+void writeBytes(GEDCOMwriter* writer, const char* text, size_t length){
+    if(writer == NULL || writer->failed || length == 0){
+        return;
+    }
+
+    if(length > writer->size - writer->used){
+        if(writer->fd >= 0){
+            writeOut(writer, text, length);
+            return;
+        }
+        if(!growWriter(writer, length)){
+            return;
+        }
+    }
+
+    memcpy(writer->buffer + writer->used, text, length);
+    writer->used += length;
+}
+
+void writeText(GEDCOMwriter* writer, const char* text){
+    if(text == NULL){
+        return;
+    }
+
+    writeBytes(writer, text, strlen(text));
+}
+
+void writeNumber(GEDCOMwriter* writer, int number, int width){
+    //digits are filled in from the end, an int has at most 10 of them
+    char digits[16];
+    int start = sizeof(digits);
+    unsigned int value = number < 0 ? 0u - (unsigned int)number : (unsigned int)number;
+
+    do{
+        digits[--start] = '0' + value % 10;
+        value /= 10;
+    }while(value > 0);
+
+    //the sign counts towards the width, as with printf
+    int fill = number < 0 ? width - 1 : width;
+    while((int)sizeof(digits) - start < fill && start > 1){
+        digits[--start] = '0';
+    }
+    if(number < 0){
+        digits[--start] = '-';
+    }
+
+    writeBytes(writer, digits + start, sizeof(digits) - start);
+}
+
+bool flushWriter(GEDCOMwriter* writer){
+    if(writer == NULL){
+        return false;
+    }
+
+    if(writer->used > 0 && writer->fd >= 0){
+        writeOut(writer, NULL, 0);
+    }
+
+    return !writer->failed;
+}
+
+bool closeWriter(GEDCOMwriter* writer){
+    if(writer == NULL){
+        return false;
+    }
+
+    bool written = flushWriter(writer);
+    if(writer->fd >= 0 && close(writer->fd) != 0){
+        written = false;
+    }
+
+    free(writer->buffer);
+    free(writer);
+
+    return written;
+}
@@ -0,0 +1,161 @@
+#include "HashTableAPI.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <assert.h>
+
+/** Function to initialize the table metadata head with the appropriate function pointers.
+*@return the table struct
+*@param expected number of elements, used to size the table so it does not have to grow
+*@param hashFunction function pointer to hash a key
+*@param compareFunction function pointer returning true if two keys are equal
+*@param deleteFunction function pointer to delete a single piece of data from the table
+**/
+HashTable initializeTable(int expected, unsigned long (*hashFunction)(const void* key), bool (*compareFunction)(const void* first,const void* second), void (*deleteFunction)(void* toBeDeleted)){
+    HashTable tmpTable;
+
+    //Asserts create a partial function...
+    assert(hashFunction != NULL);
+    assert(compareFunction != NULL);
+    assert(deleteFunction != NULL);
+
+    //keep the table at most half full for the expected number of elements
+    int size = 16;
+    while(size < expected * 2){
+        size *= 2;
+    }
+
+    tmpTable.entries = calloc(size, sizeof(TableEntry));
+    tmpTable.size = size;
+    tmpTable.length = 0;
+    tmpTable.hashKey = hashFunction;
+    tmpTable.compareKeys = compareFunction;
+    tmpTable.deleteData = deleteFunction;
+
+    return tmpTable;
+}
+
+/** Function to find the slot holding a key, or the empty slot where it would go.
+*@return index of the slot
+*@param table - the table struct
+*@param key - the key to look for
+**/
+static int findSlot(HashTable table, const void* key){
+    int mask = table.size - 1;
+    int index = (int)(table.hashKey(key) & mask);
+
+    while(table.entries[index].key != NULL){
+        if(table.compareKeys(table.entries[index].key, key)){
+            return index;
+        }
+        index = (index + 1) & mask;
+    }
+
+    return index;
+}
+
+/** Function to double the number of slots and reinsert every element.
+*@param table pointer to the table
+**/
+static void growTable(HashTable* table){
+    TableEntry* old = table->entries;
+    int oldSize = table->size;
+
+    table->size = oldSize * 2;
+    table->entries = calloc(table->size, sizeof(TableEntry));
+
+    for(int i = 0; i < oldSize; i++){
+        if(old[i].key != NULL){
+            int index = findSlot(*table, old[i].key);
+            table->entries[index] = old[i];
+        }
+    }
+
+    free(old);
+}
+
+bool insertTable(HashTable* table, const void* key, void* toBeAdded){
+    if(table == NULL || table->entries == NULL || key == NULL || toBeAdded == NULL){
+        return false;
+    }
+
+    if((table->length + 1) * 10 > table->size * 7){
+        growTable(table);
+    }
+
+    int index = findSlot(*table, key);
+    if(table->entries[index].key != NULL){
+        return false;
+    }
+
+    table->entries[index].key = key;
+    table->entries[index].data = toBeAdded;
+    table->length++;
+
+    return true;
+}
+
+void* lookupTable(HashTable table, const void* key){
+    if(table.entries == NULL || key == NULL){
+        return NULL;
+    }
+
+    int index = findSlot(table, key);
+
+    return table.entries[index].data;
+}
+
+void clearTable(HashTable* table){
+    if(table == NULL || table->entries == NULL){
+        return;
+    }
+
+    for(int i = 0; i < table->size; i++){
+        if(table->entries[i].key != NULL){
+            table->deleteData(table->entries[i].data);
+        }
+    }
+
+    free(table->entries);
+    table->entries = NULL;
+    table->size = 0;
+    table->length = 0;
+}
+
+int getTableLength(HashTable table){
+    return table.length;
+}
+
+unsigned long hashString(const void* key){
+    //FNV-1a
+    const unsigned char* str = (const unsigned char*)key;
+    unsigned long hash = 2166136261UL;
+
+    while(*str != '\0'){
+        hash ^= *str;
+        hash *= 16777619UL;
+        str++;
+    }
+
+    return hash;
+}
+
+bool compareStrings(const void* first,const void* second){
+    return strcmp((const char*)first, (const char*)second) == 0;
+}
+
+unsigned long hashPointer(const void* key){
+    //mix the address bits, the low ones are always zero because of alignment
+    uint64_t hash = (uint64_t)(uintptr_t)key;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+
+    return (unsigned long)hash;
+}
+
+bool comparePointers(const void* first,const void* second){
+    return first == second;
+}
@@ -97,8 +97,18 @@ void insertBack(List* list, void* toBeAdded){
 		return;
 	}
 	
-	Node* newNode = initializeNode(toBeAdded);
-	
+	insertNodeBack(list, initializeNode(toBeAdded));
+}
+
+void insertNodeBack(List* list, Node* newNode){
+
+	if (list == NULL || newNode == NULL){
+		return;
+	}
+
+	newNode->previous = NULL;
+	newNode->next = NULL;
+
     if (list->head == NULL && list->tail == NULL){
         list->head = newNode;
         list->tail = list->head;
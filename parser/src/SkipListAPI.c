@@ -0,0 +1,222 @@
+#include "SkipListAPI.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+
+SkipList initializeSkipList(char* (*printFunction)(void* toBePrinted),void (*deleteFunction)(void* toBeDeleted),int (*compareFunction)(const void* first,const void* second)){
+    SkipList tmpList;
+
+    //Asserts create a partial function...
+    assert(printFunction != NULL);
+    assert(deleteFunction != NULL);
+    assert(compareFunction != NULL);
+
+    tmpList.head = NULL;
+    tmpList.level = 0;
+    tmpList.length = 0;
+    tmpList.seed = 2463534242U;
+    tmpList.deleteData = deleteFunction;
+    tmpList.compare = compareFunction;
+    tmpList.printData = printFunction;
+
+    return tmpList;
+}
+
+/** Function for creating a skip list node with the given number of levels, all unlinked.
+*@return the new node, NULL on failure
+*@param data - the data for the node
+*@param level - number of levels of the node
+**/
+static SkipNode* createSkipNode(void* data, int level){
+    SkipNode* node = malloc(sizeof(SkipNode) + sizeof(SkipNode*) * level);
+    if(node == NULL){
+        return NULL;
+    }
+
+    node->data = data;
+    node->level = level;
+    for(int i = 0; i < level; i++){
+        node->next[i] = NULL;
+    }
+
+    return node;
+}
+
+/** Function to pick the number of levels for a new node, each extra level is half as likely.
+*@return the number of levels, between 1 and SKIP_MAX_LEVEL
+*@param list - pointer to the skip list, its generator is advanced
+**/
+static int randomLevel(SkipList* list){
+    //xorshift32
+    unsigned int x = list->seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    list->seed = x;
+
+    int level = 1;
+    while(level < SKIP_MAX_LEVEL && (x & 1)){
+        level++;
+        x >>= 1;
+    }
+
+    return level;
+}
+
+void clearSkipList(SkipList* list){
+    if(list == NULL || list->head == NULL){
+        return;
+    }
+
+    SkipNode* node = list->head->next[0];
+    while(node != NULL){
+        SkipNode* next = node->next[0];
+        list->deleteData(node->data);
+        free(node);
+        node = next;
+    }
+
+    free(list->head);
+    list->head = NULL;
+    list->level = 0;
+    list->length = 0;
+}
+
+void insertSkipSorted(SkipList* list, void* toBeAdded){
+    if(list == NULL || toBeAdded == NULL){
+        return;
+    }
+
+    if(list->head == NULL){
+        list->head = createSkipNode(NULL, SKIP_MAX_LEVEL);
+        if(list->head == NULL){
+            return;
+        }
+    }
+
+    //find the last node on every level that the new element compares greater than
+    SkipNode* update[SKIP_MAX_LEVEL];
+    SkipNode* node = list->head;
+    for(int i = list->level - 1; i >= 0; i--){
+        while(node->next[i] != NULL && list->compare(toBeAdded, node->next[i]->data) > 0){
+            node = node->next[i];
+        }
+        update[i] = node;
+    }
+
+    int level = randomLevel(list);
+    for(int i = list->level; i < level; i++){
+        update[i] = list->head;
+    }
+    if(level > list->level){
+        list->level = level;
+    }
+
+    SkipNode* newNode = createSkipNode(toBeAdded, level);
+    if(newNode == NULL){
+        return;
+    }
+    for(int i = 0; i < level; i++){
+        newNode->next[i] = update[i]->next[i];
+        update[i]->next[i] = newNode;
+    }
+
+    list->length++;
+}
+
+void* searchSkipList(SkipList list, const void* searchRecord){
+    if(list.head == NULL || searchRecord == NULL){
+        return NULL;
+    }
+
+    SkipNode* node = list.head;
+    for(int i = list.level - 1; i >= 0; i--){
+        while(node->next[i] != NULL && list.compare(searchRecord, node->next[i]->data) > 0){
+            node = node->next[i];
+        }
+    }
+
+    node = node->next[0];
+    if(node != NULL && list.compare(searchRecord, node->data) == 0){
+        return node->data;
+    }
+
+    return NULL;
+}
+
+int getSkipListLength(SkipList list){
+    return list.length;
+}
+
+char* skipListToString(SkipList list){
+    size_t size = 1;
+    size_t used = 0;
+    char* str = malloc(sizeof(char) * size);
+    str[0] = '\0';
+
+    SkipListIterator iter = createSkipIterator(list);
+    void* elem;
+    while((elem = nextSkipElement(&iter)) != NULL){
+        char* currDescr = list.printData(elem);
+        size_t length = strlen(currDescr);
+
+        //the string doubles when it is full, so building it stays linear
+        if(used + length + 2 > size){
+            while(used + length + 2 > size){
+                size *= 2;
+            }
+            str = realloc(str, sizeof(char) * size);
+        }
+        str[used] = '\n';
+        memcpy(str + used + 1, currDescr, length + 1);
+        used += length + 1;
+
+        free(currDescr);
+    }
+
+    return str;
+}
+
+SkipListIterator createSkipIterator(SkipList list){
+    SkipListIterator iter;
+
+    iter.current = list.head == NULL ? NULL : list.head->next[0];
+
+    return iter;
+}
+
+void* nextSkipElement(SkipListIterator* iter){
+    SkipNode* tmp = iter->current;
+
+    if(tmp == NULL){
+        return NULL;
+    }
+
+    iter->current = tmp->next[0];
+    return tmp->data;
+}
+
+List skipListToList(SkipList* list){
+    List tmpList = initializeList(list->printData, list->deleteData, list->compare);
+
+    if(list->head == NULL){
+        return tmpList;
+    }
+
+    SkipNode* node = list->head->next[0];
+    while(node != NULL){
+        SkipNode* next = node->next[0];
+        insertBack(&tmpList, node->data);
+        free(node);
+        node = next;
+    }
+
+    free(list->head);
+    list->head = NULL;
+    list->level = 0;
+    list->length = 0;
+
+    return tmpList;
+}
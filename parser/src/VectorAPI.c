@@ -0,0 +1,157 @@
+#include "VectorAPI.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+
+Vector initializeVector(char* (*printFunction)(void* toBePrinted),void (*deleteFunction)(void* toBeDeleted),int (*compareFunction)(const void* first,const void* second)){
+    Vector tmpVector;
+
+    //Asserts create a partial function...
+    assert(printFunction != NULL);
+    assert(deleteFunction != NULL);
+    assert(compareFunction != NULL);
+
+    tmpVector.data = NULL;
+    tmpVector.length = 0;
+    tmpVector.capacity = 0;
+    tmpVector.deleteData = deleteFunction;
+    tmpVector.compare = compareFunction;
+    tmpVector.printData = printFunction;
+
+    return tmpVector;
+}
+
+void clearVector(Vector* vector){
+    if(vector == NULL){
+        return;
+    }
+
+    for(int i = 0; i < vector->length; i++){
+        vector->deleteData(vector->data[i]);
+    }
+
+    free(vector->data);
+    vector->data = NULL;
+    vector->length = 0;
+    vector->capacity = 0;
+}
+
+void reserveVector(Vector* vector, int capacity){
+    if(vector == NULL || capacity <= vector->capacity){
+        return;
+    }
+
+    void** data = realloc(vector->data, sizeof(void*) * capacity);
+    if(data == NULL){
+        return;
+    }
+
+    vector->data = data;
+    vector->capacity = capacity;
+}
+
+void insertBackVector(Vector* vector, void* toBeAdded){
+    if(vector == NULL || toBeAdded == NULL){
+        return;
+    }
+
+    if(vector->length == vector->capacity){
+        reserveVector(vector, vector->capacity == 0 ? 16 : vector->capacity * 2);
+        if(vector->length == vector->capacity){
+            return;
+        }
+    }
+
+    vector->data[vector->length] = toBeAdded;
+    vector->length++;
+}
+
+void* getVectorElement(Vector vector, int index){
+    if(index < 0 || index >= vector.length){
+        return NULL;
+    }
+
+    return vector.data[index];
+}
+
+int getVectorLength(Vector vector){
+    return vector.length;
+}
+
+char* vectorToString(Vector vector){
+    size_t size = 1;
+    size_t used = 0;
+    char* str = malloc(sizeof(char) * size);
+    str[0] = '\0';
+
+    for(int i = 0; i < vector.length; i++){
+        char* currDescr = vector.printData(vector.data[i]);
+        size_t length = strlen(currDescr);
+
+        //the string doubles when it is full, so building it stays linear
+        if(used + length + 2 > size){
+            while(used + length + 2 > size){
+                size *= 2;
+            }
+            str = realloc(str, sizeof(char) * size);
+        }
+        str[used] = '\n';
+        memcpy(str + used + 1, currDescr, length + 1);
+        used += length + 1;
+
+        free(currDescr);
+    }
+
+    return str;
+}
+
+void* findVectorElement(Vector vector, bool (*customCompare)(const void* first,const void* second), const void* searchRecord){
+    for(int i = 0; i < vector.length; i++){
+        if((*customCompare)(vector.data[i], searchRecord)){
+            return vector.data[i];
+        }
+    }
+
+    return NULL;
+}
+
+VectorIterator createVectorIterator(Vector vector){
+    VectorIterator iter;
+
+    iter.current = vector.data;
+    iter.end = vector.data + vector.length;
+
+    return iter;
+}
+
+void* nextVectorElement(VectorIterator* iter){
+    if(iter->current == iter->end){
+        return NULL;
+    }
+
+    void* data = *iter->current;
+    iter->current++;
+
+    return data;
+}
+
+/** Delete function for a vector that borrows its data
+ *@param toBeDeleted - the data, which is left alone
+ **/
+static void borrowedDelete(void* toBeDeleted){
+}
+
+Vector listToVector(List list){
+    Vector vector = initializeVector(list.printData, &borrowedDelete, list.compare);
+    reserveVector(&vector, list.length);
+
+    ListIterator iter = createIterator(list);
+    void* elem;
+    while((elem = nextElement(&iter)) != NULL){
+        insertBackVector(&vector, elem);
+    }
+
+    return vector;
+}
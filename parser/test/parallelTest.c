@@ -0,0 +1,273 @@
+/**
+ * @file parallelTest.c
+ * @brief Loads files with LOAD_PARALLEL and with the single thread loader and checks that they give the same
+ * object, error and string pool statistics.  make test builds it with parts of a few lines, so the small files
+ * it writes are split up like big ones.
+ * Usage: parallelTest [file.ged ...], the given files are checked as well as the ones it writes
+ */
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include "GEDCOMparser.h"
+
+//a file to write, with the things in it that splitting could get wrong
+typedef struct{
+    const char* name;
+    const char* eol;
+    //blank lines between records
+    bool blankLines;
+    //a note whose CONT and CONC lines run past where the file would be split
+    bool longNote;
+    //an individual later in the file with the same xref as an earlier one
+    bool duplicateXref;
+    //no 0 TRLR at the end
+    bool noTrailer;
+    //a line without a tag near the end of the file
+    bool badLine;
+    //a family that links to an individual that does not exist
+    bool badReference;
+} testFile;
+
+static const testFile files[] = {
+    {"lf", "\n", false, false, false, false, false, false},
+    {"crlf", "\r\n", false, false, false, false, false, false},
+    {"cr", "\r", false, false, false, false, false, false},
+    {"lfcr", "\n\r", false, false, false, false, false, false},
+    {"blank lines", "\n", true, false, false, false, false, false},
+    {"blank lines crlf", "\r\n", true, false, false, false, false, false},
+    {"long note", "\n", false, true, false, false, false, false},
+    {"long note crlf", "\r\n", false, true, false, false, false, false},
+    {"duplicate xref", "\n", false, false, true, false, false, false},
+    {"no trailer", "\n", false, false, false, true, false, false},
+    {"no trailer lfcr", "\n\r", true, true, false, true, false, false},
+    {"bad line", "\n", false, false, false, false, true, false},
+    {"bad reference", "\n", false, false, false, false, false, true},
+    {"everything", "\r\n", true, true, true, false, false, false},
+};
+
+static const char* surnames[] = {"Smith", "Jones", "Brown", "Taylor", "Wilson"};
+static const char* places[] = {"Guelph", "Toronto", "Ottawa", "Halifax"};
+
+/** Function to write one line of a test file
+*@param file - the file
+*@param eol - line terminator
+*@param line - the line
+**/
+static void writeLine(FILE* file, const char* eol, const char* line){
+    fputs(line, file);
+    fputs(eol, file);
+}
+
+/** Function to write a test file with records enough for several parts
+*@return false if it could not be written
+*@param path - name of the file
+*@param test - what to put in it
+**/
+static bool writeTestFile(const char* path, const testFile* test){
+    FILE* file = fopen(path, "wb");
+    if(file == NULL){
+        return false;
+    }
+
+    const char* eol = test->eol;
+    char line[256];
+    writeLine(file, eol, "0 HEAD");
+    writeLine(file, eol, "1 SOUR parallelTest");
+    writeLine(file, eol, "1 GEDC");
+    writeLine(file, eol, "2 VERS 5.5");
+    writeLine(file, eol, "2 FORM LINEAGE-LINKED");
+    writeLine(file, eol, "1 CHAR ASCII");
+    writeLine(file, eol, "1 SUBM @U1@");
+
+    int individuals = 60;
+    for(int i = 0; i < individuals; i++){
+        if(test->blankLines && i % 7 == 0){
+            writeLine(file, eol, "");
+            writeLine(file, eol, "");
+        }
+
+        int xref = test->duplicateXref && i == individuals - 5 ? 3 : i;
+        sprintf(line, "0 @I%d@ INDI", xref);
+        writeLine(file, eol, line);
+        sprintf(line, "1 NAME Person%d /%s/", i, surnames[i % 5]);
+        writeLine(file, eol, line);
+        writeLine(file, eol, "1 BIRT");
+        sprintf(line, "2 DATE %d JAN 19%02d", i % 28 + 1, i % 100);
+        writeLine(file, eol, line);
+        sprintf(line, "2 PLAC %s", places[i % 4]);
+        writeLine(file, eol, line);
+        sprintf(line, "1 _NICK N%d", i % 3);
+        writeLine(file, eol, line);
+        if(i >= 2){
+            sprintf(line, "1 FAMC @F%d@", (i - 2) / 4);
+            writeLine(file, eol, line);
+        }
+
+        if(test->badLine && i == individuals - 3){
+            writeLine(file, eol, "1");
+        }
+
+        //the note sits about halfway, where a file split in two or four would be cut
+        if(test->longNote && i == individuals / 2){
+            writeLine(file, eol, "0 @N1@ NOTE a note");
+            for(int j = 0; j < 40; j++){
+                sprintf(line, "1 %s line %d of a note long enough to be split across parts", j % 2 == 0 ? "CONT" : "CONC", j);
+                writeLine(file, eol, line);
+            }
+        }
+    }
+
+    for(int f = 0; f * 4 + 2 < individuals; f++){
+        sprintf(line, "0 @F%d@ FAM", f);
+        writeLine(file, eol, line);
+        sprintf(line, "1 HUSB @I%d@", f * 2 % individuals);
+        writeLine(file, eol, line);
+        sprintf(line, "1 WIFE @I%d@", (f * 2 + 1) % individuals);
+        writeLine(file, eol, line);
+        for(int c = f * 4 + 2; c < f * 4 + 6 && c < individuals; c++){
+            sprintf(line, "1 CHIL @I%d@", c);
+            writeLine(file, eol, line);
+        }
+        writeLine(file, eol, "1 MARR");
+        sprintf(line, "2 PLAC %s", places[f % 4]);
+        writeLine(file, eol, line);
+        if(test->badReference && f == 10){
+            writeLine(file, eol, "1 CHIL @I999@");
+        }
+    }
+
+    //the submitter is the last record, so it is found by a part and not by the header
+    writeLine(file, eol, "0 @U1@ SUBM");
+    writeLine(file, eol, "1 NAME Tester");
+    writeLine(file, eol, "1 _NICK N1");
+    if(!test->noTrailer){
+        writeLine(file, eol, "0 TRLR");
+    }
+
+    return fclose(file) == 0;
+}
+
+/** Function to check that equal surnames of an interned object are one copy, whichever part they were read by
+*@return true if every surname is the same pointer as the first equal one, only the first 64 different surnames are checked
+*@param obj - object loaded with LOAD_INTERN
+**/
+static bool surnamesShared(const GEDCOMobject* obj){
+    const char* seen[64];
+    int count = 0;
+
+    ListIterator iter = createIterator(obj->individuals);
+    Individual* indi;
+    while((indi = nextElement(&iter)) != NULL){
+        int i = 0;
+        while(i < count && strcmp(seen[i], indi->surname) != 0){
+            i++;
+        }
+        if(i < count && seen[i] != indi->surname){
+            return false;
+        }
+        if(i == count && count < 64){
+            seen[count++] = indi->surname;
+        }
+    }
+
+    return true;
+}
+
+/** Function to load a file both ways and compare the results
+*@return true if they are the same
+*@param path - name of the file
+*@param flags - flags for both loaders, LOAD_PARALLEL is added for the second
+**/
+static bool sameLoad(char* path, int flags){
+    GEDCOMobject* serial = NULL;
+    GEDCOMobject* parallel = NULL;
+    GEDCOMerror serialError = createGEDCOMflags(path, &serial, flags);
+    GEDCOMerror parallelError = createGEDCOMflags(path, &parallel, flags | LOAD_PARALLEL);
+
+    bool same = true;
+    if(serialError.type != parallelError.type || serialError.line != parallelError.line){
+        printf("    error %d line %d, parallel error %d line %d\n", serialError.type, serialError.line, parallelError.type, parallelError.line);
+        same = false;
+    }
+    else if(serialError.type == OK){
+        char* serialText = printGEDCOM(serial);
+        char* parallelText = printGEDCOM(parallel);
+        if(strcmp(serialText, parallelText) != 0){
+            printf("    printGEDCOM differs\n");
+            same = false;
+        }
+        free(serialText);
+        free(parallelText);
+
+        GEDCOMstats serialStats = getGEDCOMstats(serial);
+        GEDCOMstats parallelStats = getGEDCOMstats(parallel);
+        if(serialStats.strings != parallelStats.strings || serialStats.uniqueStrings != parallelStats.uniqueStrings ||
+            serialStats.stringBytes != parallelStats.stringBytes || serialStats.savedBytes != parallelStats.savedBytes){
+            printf("    strings %d/%d bytes %zu/%zu, parallel strings %d/%d bytes %zu/%zu\n",
+                serialStats.strings, serialStats.uniqueStrings, serialStats.stringBytes, serialStats.savedBytes,
+                parallelStats.strings, parallelStats.uniqueStrings, parallelStats.stringBytes, parallelStats.savedBytes);
+            same = false;
+        }
+
+        if((flags & LOAD_INTERN) && !surnamesShared(parallel)){
+            printf("    parallel surnames are not shared\n");
+            same = false;
+        }
+    }
+
+    deleteGEDCOM(serial);
+    deleteGEDCOM(parallel);
+
+    return same;
+}
+
+/** Function to check one file with and without the string pool
+*@return true if both loads matched
+*@param path - name of the file
+*@param name - what to call it in the output
+**/
+static bool checkFile(char* path, const char* name){
+    bool same = sameLoad(path, LOAD_DEFAULT) && sameLoad(path, LOAD_INTERN);
+    printf("%s %s\n", same ? "ok  " : "FAIL", name);
+
+    return same;
+}
+
+int main(int argc, char** argv){
+    char directory[] = "/tmp/parallelTestXXXXXX";
+    if(mkdtemp(directory) == NULL){
+        fprintf(stderr, "cannot make a directory for the test files\n");
+        return 1;
+    }
+
+    int failed = 0;
+    int count = sizeof(files) / sizeof(files[0]);
+    for(int i = 0; i < count; i++){
+        char path[sizeof(directory) + 32];
+        sprintf(path, "%s/test%d.ged", directory, i);
+        if(!writeTestFile(path, &files[i])){
+            printf("FAIL %s, the file could not be written\n", files[i].name);
+            failed++;
+            continue;
+        }
+
+        if(!checkFile(path, files[i].name)){
+            failed++;
+        }
+        unlink(path);
+    }
+    rmdir(directory);
+
+    for(int i = 1; i < argc; i++){
+        if(!checkFile(argv[i], argv[i])){
+            failed++;
+        }
+    }
+
+    printf("%d of %d files differ\n", failed, count + argc - 1);
+
+    return failed == 0 ? 0 : 1;
+}
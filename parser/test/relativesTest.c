@@ -0,0 +1,170 @@
+/**
+ * @file relativesTest.c
+ * @brief Asks every descendant and ancestor question of each individual of a file loaded with LOAD_GRAPH and
+ * loaded without it, and checks that the family graph gives the same answers as the family lists.
+ * Usage: relativesTest [file.ged ...], the given files are checked as well as the ones it writes
+ */
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include "GEDCOMparser.h"
+
+//a file to write, with the records that let the two ways of choosing families disagree
+typedef struct{
+    const char* name;
+    const char* text;
+} testFile;
+
+static const testFile files[] = {
+    //the son has the father's name, so by name he is also the husband of his parents' family
+    {"same name", "0 HEAD\n1 SOUR relativesTest\n1 GEDC\n2 VERS 5.5\n2 FORM LINEAGE-LINKED\n1 CHAR ASCII\n1 SUBM @U1@\n"
+        "0 @I1@ INDI\n1 NAME John /Smith/\n1 FAMS @F1@\n"
+        "0 @I2@ INDI\n1 NAME Mary /Jones/\n1 FAMS @F1@\n"
+        "0 @I3@ INDI\n1 NAME John /Smith/\n1 FAMC @F1@\n"
+        "0 @I4@ INDI\n1 NAME Ann /Smith/\n1 FAMC @F1@\n"
+        "0 @F1@ FAM\n1 HUSB @I1@\n1 WIFE @I2@\n1 CHIL @I3@\n1 CHIL @I4@\n"
+        "0 @U1@ SUBM\n1 NAME Tester\n0 TRLR\n"},
+    //the same, with a family of the son's own and births that tell father and son apart for getDescendants
+    {"same name with families", "0 HEAD\n1 SOUR relativesTest\n1 GEDC\n2 VERS 5.5\n2 FORM LINEAGE-LINKED\n1 CHAR ASCII\n1 SUBM @U1@\n"
+        "0 @I1@ INDI\n1 NAME John /Smith/\n1 BIRT\n2 DATE 1 JAN 1900\n1 FAMS @F1@\n"
+        "0 @I2@ INDI\n1 NAME Mary /Jones/\n1 FAMS @F1@\n"
+        "0 @I3@ INDI\n1 NAME John /Smith/\n1 BIRT\n2 DATE 1 JAN 1930\n1 FAMC @F1@\n1 FAMS @F2@\n"
+        "0 @I4@ INDI\n1 NAME Ann /Smith/\n1 FAMC @F1@\n"
+        "0 @I5@ INDI\n1 NAME Sue /Brown/\n1 FAMS @F2@\n"
+        "0 @I6@ INDI\n1 NAME Tom /Smith/\n1 FAMC @F2@\n"
+        "0 @I7@ INDI\n1 NAME John /Smith/\n1 FAMC @F2@\n"
+        "0 @F1@ FAM\n1 HUSB @I1@\n1 WIFE @I2@\n1 CHIL @I3@\n1 CHIL @I4@\n"
+        "0 @F2@ FAM\n1 HUSB @I3@\n1 WIFE @I5@\n1 CHIL @I6@\n1 CHIL @I7@\n"
+        "0 @U1@ SUBM\n1 NAME Tester\n0 TRLR\n"},
+};
+
+/** Function to compare two answers as JSON and free them
+*@return true if they are the same
+*@param plain - JSON of the answer without the graph
+*@param graph - JSON of the answer with the graph
+*@param question - what was asked, for the output
+*@param who - number of the individual it was asked about
+**/
+static bool sameAnswer(char* plain, char* graph, const char* question, int who){
+    bool same = strcmp(plain, graph) == 0;
+    if(!same){
+        printf("    %s of individual %d: %s, with the graph %s\n", question, who, plain, graph);
+    }
+    free(plain);
+    free(graph);
+
+    return same;
+}
+
+/** Function to ask the questions of every individual of two objects loaded from the same file
+*@return true if all the answers are the same
+*@param plain - object loaded without the graph
+*@param graph - object loaded with LOAD_GRAPH
+**/
+static bool askAll(GEDCOMobject* plain, GEDCOMobject* graph){
+    bool same = true;
+
+    //the individuals of both objects are in file order, so the nth of one is the nth of the other
+    ListIterator plainIter = createIterator(plain->individuals);
+    ListIterator graphIter = createIterator(graph->individuals);
+    Individual* plainIndi;
+    Individual* graphIndi;
+    int who = 0;
+    while((plainIndi = nextElement(&plainIter)) != NULL && (graphIndi = nextElement(&graphIter)) != NULL){
+        who++;
+
+        List plainList = getDescendants(plain, plainIndi);
+        List graphList = getDescendants(graph, graphIndi);
+        same = sameAnswer(iListToJSON(plainList), iListToJSON(graphList), "getDescendants", who) && same;
+        clearList(&plainList);
+        clearList(&graphList);
+
+        for(int maxGen = 0; maxGen <= 3; maxGen++){
+            plainList = getDescendantListN(plain, plainIndi, maxGen);
+            graphList = getDescendantListN(graph, graphIndi, maxGen);
+            same = sameAnswer(gListToJSON(plainList), gListToJSON(graphList), "getDescendantListN", who) && same;
+            clearList(&plainList);
+            clearList(&graphList);
+
+            plainList = getAncestorListN(plain, plainIndi, maxGen);
+            graphList = getAncestorListN(graph, graphIndi, maxGen);
+            same = sameAnswer(gListToJSON(plainList), gListToJSON(graphList), "getAncestorListN", who) && same;
+            clearList(&plainList);
+            clearList(&graphList);
+        }
+    }
+
+    return same;
+}
+
+/** Function to ask the questions of every individual of a file loaded both ways
+*@return true if all the answers are the same
+*@param path - name of the file
+*@param name - what to call it in the output
+**/
+static bool checkFile(char* path, const char* name){
+    GEDCOMobject* plain = NULL;
+    GEDCOMobject* graph = NULL;
+    GEDCOMerror plainError = createGEDCOMflags(path, &plain, LOAD_DEFAULT);
+    GEDCOMerror graphError = createGEDCOMflags(path, &graph, LOAD_GRAPH);
+
+    //a file neither loader accepts has no questions to ask
+    bool same = plainError.type == graphError.type;
+    if(!same){
+        printf("    errors %d and %d\n", plainError.type, graphError.type);
+    }
+    else if(plainError.type == OK){
+        same = askAll(plain, graph);
+    }
+
+    deleteGEDCOM(plain);
+    deleteGEDCOM(graph);
+
+    printf("%s %s\n", same ? "ok  " : "FAIL", name);
+
+    return same;
+}
+
+int main(int argc, char** argv){
+    char directory[] = "/tmp/relativesTestXXXXXX";
+    if(mkdtemp(directory) == NULL){
+        fprintf(stderr, "cannot make a directory for the test files\n");
+        return 1;
+    }
+
+    int failed = 0;
+    int count = sizeof(files) / sizeof(files[0]);
+    for(int i = 0; i < count; i++){
+        char path[sizeof(directory) + 32];
+        sprintf(path, "%s/test%d.ged", directory, i);
+        FILE* file = fopen(path, "wb");
+        bool written = file != NULL && fputs(files[i].text, file) >= 0;
+        if(file != NULL && fclose(file) != 0){
+            written = false;
+        }
+        if(!written){
+            printf("FAIL %s, the file could not be written\n", files[i].name);
+            failed++;
+            continue;
+        }
+
+        if(!checkFile(path, files[i].name)){
+            failed++;
+        }
+        unlink(path);
+    }
+    rmdir(directory);
+
+    for(int i = 1; i < argc; i++){
+        if(!checkFile(argv[i], argv[i])){
+            failed++;
+        }
+    }
+
+    printf("%d of %d files differ\n", failed, count + argc - 1);
+
+    return failed == 0 ? 0 : 1;
+}
@@ -535,14 +535,18 @@ function addIndividuals(){
             'secondname': lastname
         },   //The server endpoint we are connecting to
         success: function (data) {
+            if(data.error == 0){
+                document.getElementById("statusarea").value = "added a new individual " + firstname + " " + lastname + " " +  "to file " + filename;
+            }
+            else{
+                document.getElementById("statusarea").value = "could not add " + firstname + " " + lastname + " to file " + filename + " (error " + data.error + ")";
+            }
         },
         fail: function(error) {
             // Non-200 return, do something with error
             console.log(error); 
         }
     });
-
-    document.getElementById("statusarea").value = "added a new individual " + firstname + " " + lastname + " " +  "to file " + filename;
     
     document.getElementById("indifirstname").value = "";
     document.getElementById("indilastname").value = "";